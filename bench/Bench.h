@@ -0,0 +1,87 @@
+#pragma once
+#include "Utils/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Bench {
+// Keeps the compiler from optimizing away a value the benchmark computed.
+template <typename T> inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0; // Per sample
+    int samples = 0;
+    double ns_min = 0;
+    double ns_median = 0;
+    double ns_max = 0;
+};
+
+class Runner {
+public:
+    Runner(std::ostream &out, std::string filter, std::chrono::milliseconds sample_time,
+           int samples)
+        : out(out), filter(std::move(filter)), sample_time(sample_time), samples(samples) {}
+
+    // Calibrates an iteration count that fills one sample, then times `samples` runs of it.
+    // Each result is printed as one JSON object per line so runs can be diffed by scripts.
+    template <typename Fn> void run(const std::string &name, Fn &&fn) {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+
+        std::uint64_t iters = 1;
+        while (true) {
+            auto elapsed = time_iterations(fn, iters);
+            if (elapsed >= sample_time || iters >= (1ull << 32))
+                break;
+            iters *= 2;
+        }
+
+        std::vector<double> ns_per_op;
+        for (int i = 0; i < samples; i++) {
+            auto elapsed = time_iterations(fn, iters);
+            ns_per_op.push_back(static_cast<double>(elapsed.count()) / iters);
+        }
+        std::sort(ns_per_op.begin(), ns_per_op.end());
+
+        Result r;
+        r.name = name;
+        r.iterations = iters;
+        r.samples = samples;
+        r.ns_min = ns_per_op.front();
+        r.ns_median = ns_per_op[ns_per_op.size() / 2];
+        r.ns_max = ns_per_op.back();
+        print(r);
+    }
+
+private:
+    template <typename Fn>
+    static std::chrono::nanoseconds time_iterations(Fn &fn, std::uint64_t iters) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < iters; i++)
+            fn();
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    void print(const Result &r) {
+        Json::Value j;
+        j["benchmark"] = r.name;
+        j["iterations"] = static_cast<double>(r.iterations);
+        j["samples"] = r.samples;
+        j["ns_per_op_min"] = r.ns_min;
+        j["ns_per_op_median"] = r.ns_median;
+        j["ns_per_op_max"] = r.ns_max;
+        out << j.dump() << "\n" << std::flush;
+    }
+
+    std::ostream &out;
+    std::string filter;
+    std::chrono::milliseconds sample_time;
+    int samples;
+};
+} // namespace Bench
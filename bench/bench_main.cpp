@@ -0,0 +1,210 @@
+#include "BaselineJson.h"
+#include "Bench.h"
+#include "Decoder/Decoder.h"
+#include "Decoder/DecoderRegistry.h"
+#include "Log/Log.h"
+#include "Output/StdoutWriter.h"
+#include "State/AdvertDeduper.h"
+#include "State/DeviceState.h"
+#include "Utils/json.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+static const std::string DEVICE_PATH = "/org/bluez/hci0/dev_AA_BB_CC_DD_EE_FF";
+
+// Apple proximity pairing payloads (manufacturer data without the CID)
+// L: 90% R: 80%, Case: 70% and charging
+static const std::vector<std::uint8_t> PAYLOAD_VALID = {
+    0x07, 0x19, 0x01, 0x0E, 0x20, 0x55, 0x98, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+// Nearby Info message, which is not a battery packet
+static const std::vector<std::uint8_t> PAYLOAD_INVALID = {0x10, 0x05, 0x01, 0x18,
+                                                          0x2B, 0x9A, 0x1C, 0x00};
+// Lid open in pairing mode, no battery information
+static const std::vector<std::uint8_t> PAYLOAD_PAIRING = {
+    0x07, 0x19, 0x07, 0x0E, 0x20, 0x55, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+// Beats Studio Buds (model 0x1120): L: 60% R: 50%, Case: 100%
+static const std::vector<std::uint8_t> PAYLOAD_BEATS = {
+    0x07, 0x19, 0x01, 0x11, 0x20, 0x55, 0x65, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// ManufacturerData as a busy room delivers it: Apple status and Nearby messages next to
+// vendors without a decoder (Microsoft Swift Pair, Samsung, Google)
+static const std::map<std::uint16_t, std::vector<std::uint8_t>> MIXED_ADVERTS = {
+    {0x0006, {0x03, 0x00, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05}},
+    {0x004C, PAYLOAD_VALID},
+    {0x0075, {0x42, 0x09, 0x81, 0x02, 0x14, 0x15, 0x03, 0x21, 0x01, 0x09}},
+    {0x00E0, {0x00, 0x1A, 0x2B, 0x3C}},
+};
+
+// Control message read from stdin
+static const std::string COMMAND_LINE = R"({"cmd": "pair", "mac": "AA:BB:CC:DD:EE:FF"})";
+static const std::string COMMAND_LINE_ESCAPED =
+    R"({"cmd": "select", "mac": "AA:BB:CC:DD:EE:FF", "note": "left \"pod\"\n\u00e9"})";
+
+// Shape of the objects exchanged with Waybar
+static const std::string WAYBAR_LINE =
+    R"({"class": "connected", "text": "  L:90% R:80% C:70%", "tooltip": "Left: 90%"})";
+
+int main(int argc, char **argv) {
+    // Usage: hyprpods_bench [filter] [sample_ms] [samples]
+    std::string filter = argc > 1 ? argv[1] : "";
+    int sample_ms = argc > 2 ? std::atoi(argv[2]) : 50;
+    int samples = argc > 3 ? std::atoi(argv[3]) : 10;
+
+    // Waybar output is thrown away, results go to stdout
+    int null_fd = open("/dev/null", O_WRONLY);
+    StdoutWriter writer(null_fd);
+
+    Bench::Runner runner(std::cout, filter, std::chrono::milliseconds(sample_ms), samples);
+
+    runner.run("decoder/parse_valid", [] {
+        auto r = Decoder::parse(PAYLOAD_VALID);
+        Bench::do_not_optimize(r);
+    });
+
+    runner.run("decoder/parse_invalid", [] {
+        auto r = Decoder::parse(PAYLOAD_INVALID);
+        Bench::do_not_optimize(r);
+    });
+
+    runner.run("decoder/parse_pairing", [] {
+        auto r = Decoder::parse(PAYLOAD_PAIRING);
+        Bench::do_not_optimize(r);
+    });
+
+    runner.run("registry/decode_beats", [] {
+        auto r = DecoderRegistry::decode(0x004C, PAYLOAD_BEATS);
+        Bench::do_not_optimize(r);
+    });
+
+    // One ManufacturerData dict per round, routed the way the advert handler does it
+    runner.run("registry/dispatch_mixed", [] {
+        for (const auto &[cid, payload] : MIXED_ADVERTS) {
+            if (!DecoderRegistry::handles(cid))
+                continue;
+            auto r = DecoderRegistry::decode(cid, payload);
+            Bench::do_not_optimize(r);
+        }
+    });
+
+    {
+        DeviceState state(writer);
+        state.set_adapter_powered(true);
+        BatteryData data = *Decoder::parse(PAYLOAD_VALID);
+        runner.run("state/update_from_packet", [&] {
+            bool changed = state.update_from_packet(data, DEVICE_PATH);
+            Bench::do_not_optimize(changed);
+        });
+    }
+
+    {
+        DeviceState state(writer);
+        state.set_adapter_powered(true);
+        state.update_from_packet(*Decoder::parse(PAYLOAD_VALID), DEVICE_PATH);
+        runner.run("state/print_json", [&] { state.print_json(); });
+    }
+
+    {
+        Json::Value j;
+        j["text"] = "  L:90% R:80% C:70%";
+        j["tooltip"] = "Left: 90%\nRight: 80%\nCase: 70%\nCharging";
+        j["class"] = "connected";
+        runner.run("json/dump", [&] {
+            auto s = j.dump();
+            Bench::do_not_optimize(s);
+        });
+    }
+
+    runner.run("output/write_line", [&] { writer.write_line(WAYBAR_LINE); });
+
+    runner.run("json/parse", [] {
+        auto v = Json::Parser::parse(WAYBAR_LINE);
+        Bench::do_not_optimize(v);
+    });
+
+    // Baseline parser vs. the owning Value tree vs. arena-backed views, on the messages
+    // the command channel sees
+    runner.run("json/parse_command_baseline", [] {
+        auto v = BaselineJson::Parser::parse(COMMAND_LINE);
+        Bench::do_not_optimize(v);
+    });
+
+    runner.run("json/parse_command_escaped_baseline", [] {
+        auto v = BaselineJson::Parser::parse(COMMAND_LINE_ESCAPED);
+        Bench::do_not_optimize(v);
+    });
+
+    runner.run("json/parse_command", [] {
+        auto v = Json::Parser::parse(COMMAND_LINE);
+        Bench::do_not_optimize(v);
+    });
+
+    runner.run("json/parse_command_escaped", [] {
+        auto v = Json::Parser::parse(COMMAND_LINE_ESCAPED);
+        Bench::do_not_optimize(v);
+    });
+
+    {
+        Json::Arena arena;
+        runner.run("json/parse_view_command", [&] {
+            arena.reset();
+            auto n = Json::Parser::parse(COMMAND_LINE, arena);
+            Bench::do_not_optimize(n);
+        });
+
+        runner.run("json/parse_view_command_escaped", [&] {
+            arena.reset();
+            auto n = Json::Parser::parse(COMMAND_LINE_ESCAPED, arena);
+            Bench::do_not_optimize(n);
+        });
+    }
+
+    {
+        // The same advert arriving from two adapters: the second copy is dropped
+        AdvertDeduper deduper(std::chrono::milliseconds(150));
+        const std::string second_path = "/org/bluez/hci1/dev_AA_BB_CC_DD_EE_FF";
+        std::vector<std::uint8_t> payload = PAYLOAD_VALID;
+        std::int16_t rssi = -60;
+        runner.run("dedup/accept_two_adapters", [&] {
+            payload[8]++; // A fresh advert each round
+            bool first = deduper.accept(DEVICE_PATH, payload, rssi);
+            bool second = deduper.accept(second_path, payload, rssi + 5);
+            Bench::do_not_optimize(first);
+            Bench::do_not_optimize(second);
+        });
+    }
+
+    {
+        DeviceState state(writer);
+        state.set_adapter_powered(true);
+        runner.run("pipeline/decode_update_print", [&] {
+            if (auto result = Decoder::parse(PAYLOAD_VALID)) {
+                if (state.update_from_packet(*result, DEVICE_PATH))
+                    state.print_json();
+            }
+        });
+    }
+
+    {
+        // Log records go to stderr; point it at /dev/null while timing
+        int saved_stderr = dup(STDERR_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        Log::init(Log::Level::Info);
+
+        runner.run("log/disabled_level",
+                   [] { LOG_DEBUG("Connection State Changed:", DEVICE_PATH, 1); });
+        runner.run("log/enabled_level",
+                   [] { LOG_INFO("Connection State Changed:", DEVICE_PATH, 1); });
+
+        Log::shutdown();
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+    }
+
+    close(null_fd);
+    return 0;
+}
@@ -1,13 +1,26 @@
 #include "BluezClient.h"
 #include "../Config/Config.h"
-#include "../Decoder/Decoder.h"
+#include "../Decoder/DecoderRegistry.h"
+#include "../Log/Log.h"
 #include "../Utils/Utils.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <chrono>
+#include <cerrno>
 #include <csignal>
-#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <map>
+#include <poll.h>
+#include <stdexcept>
 #include <string>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
 #include <thread>
+#include <unistd.h>
 
 // DBus Constants
 static const sdbus::ServiceName BLUEZ_SERVICE{"org.bluez"};
@@ -15,6 +28,9 @@ static const sdbus::InterfaceName ADAPTER_IFACE{"org.bluez.Adapter1"};
 static const sdbus::InterfaceName DEVICE_IFACE{"org.bluez.Device1"};
 static const sdbus::InterfaceName PROP_IFACE{"org.freedesktop.DBus.Properties"};
 static const sdbus::InterfaceName MGR_IFACE{"org.freedesktop.DBus.ObjectManager"};
+static const sdbus::ServiceName LOGIN_SERVICE{"org.freedesktop.login1"};
+static const sdbus::ObjectPath LOGIN_PATH{"/org/freedesktop/login1"};
+static const sdbus::InterfaceName LOGIN_MGR_IFACE{"org.freedesktop.login1.Manager"};
 
 // Helper to reduce boilerplate and repeated object construction
 static std::unique_ptr<sdbus::IProxy> createBluezProxy(sdbus::IConnection &conn,
@@ -22,13 +38,48 @@ static std::unique_ptr<sdbus::IProxy> createBluezProxy(sdbus::IConnection &conn,
     return sdbus::createProxy(conn, BLUEZ_SERVICE, sdbus::ObjectPath(path));
 }
 
-BluezClient::BluezClient() {}
+// LE only. While active every advert is reported so battery changes show up at once;
+// while idle BlueZ reports a device only when its data changes, which keeps the steady
+// stream of foreign adverts (phones, beacons, ...) from waking us at all.
+static std::map<std::string, sdbus::Variant> discovery_filter(bool idle) {
+    std::map<std::string, sdbus::Variant> filter;
+    filter["Transport"] = sdbus::Variant(std::string("le"));
+    filter["DuplicateData"] = sdbus::Variant(!idle);
+    return filter;
+}
+
+// Config::IDLE_AFTER_SECONDS unless overridden through the environment
+static std::chrono::seconds idle_after_from_env() {
+    std::chrono::seconds fallback(Config::IDLE_AFTER_SECONDS);
+    const char *env = std::getenv(Config::IDLE_AFTER_ENV);
+    if (!env)
+        return fallback;
+
+    int seconds = 0;
+    std::string_view str(env);
+    auto res = std::from_chars(str.data(), str.data() + str.size(), seconds);
+    if (res.ec != std::errc() || res.ptr != str.data() + str.size() || seconds < 1) {
+        LOG_WARN("Ignoring invalid idle timeout:", env);
+        return fallback;
+    }
+    return std::chrono::seconds(seconds);
+}
+
+BluezClient::BluezClient()
+    : state(writer), deduper(std::chrono::milliseconds(Config::DEDUP_WINDOW_MS)),
+      commands(STDIN_FILENO, [this](const Command &cmd) { handle_command(cmd); }),
+      idle_after(idle_after_from_env()) {}
 
 BluezClient::~BluezClient() {
+    if (signal_fd >= 0)
+        close(signal_fd);
+
     // Attempt to stop discovery on exit
-    if (connection && !adapter_path.empty()) {
+    if (!connection)
+        return;
+    for (const auto &path : scanning) {
         try {
-            auto proxy = createBluezProxy(*connection, adapter_path);
+            auto proxy = createBluezProxy(*connection, path);
             proxy->callMethod("StopDiscovery").onInterface(ADAPTER_IFACE);
         } catch (...) {
         }
@@ -40,101 +91,498 @@ void BluezClient::run() {
     state.print_json(true);
 
     init_connection();
-    find_adapter();
 
-    if (adapter_path.empty()) {
-        std::cerr << "Error: No Bluetooth Adapter found." << std::endl;
-        return;
+    // Subscribe before loading objects so no power or hotplug change is missed
+    setup_signal_handler();
+    setup_adapter_watch();
+    load_objects();
+
+    if (cache.adapters().empty()) {
+        LOG_WARN("No Bluetooth Adapter found, waiting for one to appear");
     }
 
-    state.set_adapter_powered(true);
-    setup_signal_handler();
-    start_signal_listener();
+    update_adapter_state();
+    setup_sleep_watch();
+    setup_unix_signals();
+
+    // Start out active, so devices already nearby show up quickly
+    last_activity = std::chrono::steady_clock::now();
     start_scanning();
 
-    // Enters the blocking event loop provided by sdbus-c++
-    connection->enterEventLoop();
+    run_event_loop();
+}
+
+// Milliseconds until `deadline` for poll(), rounded up so we never wake just before it
+static int ms_until(std::chrono::steady_clock::time_point deadline,
+                    std::chrono::steady_clock::time_point now) {
+    if (deadline <= now)
+        return 0;
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return static_cast<int>(std::min<long long>(ms, std::numeric_limits<int>::max()));
+}
+
+void BluezClient::run_event_loop() {
+    // Our own poll loop instead of enterEventLoop(), so stdout, stdin and signals are waited
+    // on too. There is no periodic tick: the timeout is the nearest real deadline, and when
+    // idle and hidden there is none, so only bus traffic that passed the match rules wakes us.
+    enum { BUS, BUS_EVENT, OUTPUT, COMMANDS, SIGNALS, FD_COUNT };
+    using Clock = std::chrono::steady_clock;
+
+    while (running) {
+        auto poll_data = connection->getEventLoopPollData();
+
+        // poll() skips negative fds. Stdout is always watched: a pipe whose reader went
+        // away reports POLLERR even with no events requested.
+        struct pollfd fds[FD_COUNT] = {
+            {poll_data.fd, poll_data.events, 0},
+            {poll_data.eventFd, POLLIN, 0},
+            {writer.fd(), static_cast<short>(writer.wants_write() ? POLLOUT : 0), 0},
+            {commands.is_open() ? commands.fd() : -1, POLLIN, 0},
+            {signal_fd, POLLIN, 0},
+        };
+
+        auto now = Clock::now();
+        auto hide_at = state.hide_deadline();
+        auto idle_at = last_activity + idle_after;
+
+        int timeout = poll_data.getPollTimeout();
+        auto take_min = [&timeout](int t) {
+            if (t >= 0 && (timeout < 0 || t < timeout))
+                timeout = t;
+        };
+        take_min(writer.timeout_ms());
+        if (hide_at)
+            take_min(ms_until(*hide_at, now));
+        if (!idle)
+            take_min(ms_until(idle_at, now));
+
+        if (poll(fds, FD_COUNT, timeout) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+        loop_wakeups++;
+
+        if (fds[OUTPUT].revents & POLLERR)
+            writer.close();
+        else if (writer.has_pending())
+            writer.flush();
+
+        while (connection->processPendingEvent()) {
+        }
+
+        if (fds[COMMANDS].revents != 0)
+            commands.on_readable();
+
+        if (fds[SIGNALS].revents != 0)
+            handle_unix_signals();
+
+        now = Clock::now();
+        if (hide_at && now >= *hide_at)
+            state.print_json(); // Hides the widget now that the reading is stale
+        if (!idle && now >= last_activity + idle_after)
+            enter_idle();
+
+        if (writer.is_closed()) {
+            // Nobody is left to show what we find (Waybar exited)
+            LOG_INFO("Output closed, exiting");
+            running = false;
+        }
+    }
+}
+
+void BluezClient::note_activity() {
+    last_activity = std::chrono::steady_clock::now();
+    if (!idle)
+        return;
+    idle = false;
+    LOG_INFO("Leaving idle mode");
+    apply_scan_mode();
+}
+
+void BluezClient::enter_idle() {
+    idle = true;
+    LOG_INFO("Nothing heard for a while, entering idle mode");
+    apply_scan_mode();
+}
+
+void BluezClient::apply_scan_mode() {
+    // Only the filter changes; the discovery session itself keeps running
+    for (const auto &path : scanning) {
+        try {
+            auto proxy = createBluezProxy(*connection, path);
+            proxy->callMethod("SetDiscoveryFilter")
+                .onInterface(ADAPTER_IFACE)
+                .withArguments(discovery_filter(idle));
+        } catch (const sdbus::Error &e) {
+            LOG_WARN("Failed to update discovery filter:", e.getMessage());
+        }
+    }
+}
+
+void BluezClient::handle_command(const Command &cmd) {
+    switch (cmd.type) {
+    case Command::Type::Pair: {
+        std::string mac = cmd.mac.empty() ? state.get_pairing_mac() : std::string(cmd.mac);
+        if (mac.empty()) {
+            LOG_WARN("Pair command without a device to pair with");
+            return;
+        }
+        trigger_pairing(mac);
+        break;
+    }
+    case Command::Type::Rescan:
+        LOG_INFO("Restarting discovery");
+        stop_scanning();
+        start_scanning();
+        note_activity();
+        break;
+    case Command::Type::Select:
+        select_device(cmd.mac);
+        break;
+    case Command::Type::SetRate:
+        writer.set_min_interval(std::chrono::milliseconds(cmd.interval_ms));
+        LOG_INFO("Output interval set (ms)", {}, cmd.interval_ms);
+        break;
+    case Command::Type::DumpStats:
+        dump_stats();
+        break;
+    }
+}
+
+void BluezClient::select_device(std::string_view mac) {
+    if (mac.empty()) {
+        selected_device.clear();
+        LOG_INFO("Device selection cleared");
+        return;
+    }
+
+    if (!cache.find_device_by_address(std::string(mac)))
+        LOG_WARN("Selected device is not known to BlueZ yet:", mac);
+
+    // Matched against the object path, e.g. /org/bluez/hci0/dev_AA_BB_CC_DD_EE_FF
+    selected_device = "/dev_";
+    for (char c : mac)
+        selected_device += c == ':' ? '_' : static_cast<char>(std::toupper(c));
+    LOG_INFO("Device selected:", mac);
+}
+
+bool BluezClient::is_selected(const std::string &path) const {
+    if (selected_device.empty())
+        return true;
+    return path.size() >= selected_device.size() &&
+           path.compare(path.size() - selected_device.size(), std::string::npos,
+                        selected_device) == 0;
+}
+
+bool BluezClient::selected_connected() const {
+    for (const auto &device : cache.connected_devices()) {
+        if (is_selected(device.path))
+            return true;
+    }
+    return false;
+}
+
+void BluezClient::dump_stats() const {
+    Json::Value j;
+    j["stdout"]["written"] = static_cast<double>(writer.lines_written());
+    j["stdout"]["dropped"] = static_cast<double>(writer.lines_dropped());
+    j["log"]["dropped"] = static_cast<double>(Log::dropped());
+    j["devices_cached"] = static_cast<double>(cache.device_count());
+    j["idle"] = idle;
+    j["loop_wakeups"] = static_cast<double>(loop_wakeups);
+
+    // Cost of the process so far: on-CPU ns and timeslices from schedstat,
+    // voluntary context switches (sleeps) from getrusage
+    std::ifstream schedstat("/proc/self/schedstat");
+    double cpu_ns = 0, wait_ns = 0, timeslices = 0;
+    if (schedstat >> cpu_ns >> wait_ns >> timeslices) {
+        j["process"]["cpu_ns"] = cpu_ns;
+        j["process"]["timeslices"] = timeslices;
+    }
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        j["process"]["voluntary_switches"] = static_cast<double>(usage.ru_nvcsw);
+    j["adapters"] = Json::Object{};
+    for (const auto &[path, stats] : deduper.stats()) {
+        Json::Value &a = j["adapters"][path];
+        a["received"] = static_cast<double>(stats.received);
+        a["forwarded"] = static_cast<double>(stats.forwarded);
+        a["duplicates"] = static_cast<double>(stats.duplicates);
+        a["strongest_signal"] = static_cast<double>(stats.strongest_signal);
+        a["scanning"] = scanning.count(path) != 0;
+    }
+
+    // Stdout belongs to Waybar, so the answer goes to stderr as one line. The log drain
+    // thread writes it, so a stderr nobody reads can't stall the event loop.
+    std::string line = j.dump();
+    line += '\n';
+    Log::write_line(std::move(line));
 }
 
 void BluezClient::init_connection() { connection = sdbus::createSystemBusConnection(); }
 
-void BluezClient::find_adapter() {
-    // Try to find the adapter up to i times
+void BluezClient::load_objects() {
+    // Retry only while BlueZ doesn't answer. An answer without adapters is final:
+    // a late adapter arrives through InterfacesAdded once the event loop runs.
     for (int i = 0; i < 5; i++) {
         try {
             auto proxy = createBluezProxy(*connection, "/");
 
-            // Map: ObjectPath -> InterfaceName -> PropertyName -> Variant
-            std::map<sdbus::ObjectPath,
-                     std::map<std::string, std::map<std::string, sdbus::Variant>>>
-                objects;
-
+            // The only full object dump; from here on the cache follows the signals
+            ObjectCache::ManagedObjects objects;
             proxy->callMethod("GetManagedObjects").onInterface(MGR_IFACE).storeResultsTo(objects);
+            cache.load(objects);
 
-            for (const auto &[path, interfaces] : objects) {
-                if (interfaces.count(ADAPTER_IFACE)) {
-                    adapter_path = path;
-                    if (Config::DEBUG_MODE)
-                        std::cerr << "DEBUG: Found Adapter at " << adapter_path << std::endl;
-                    return;
-                }
-            }
+            for (const auto &adapter : cache.adapters())
+                LOG_DEBUG("Found Adapter at", adapter.path, adapter.powered);
+            return;
         } catch (const sdbus::Error &e) {
-            if (Config::DEBUG_MODE)
-                std::cerr << "DBus Error finding adapter: " << e.getMessage() << std::endl;
+            LOG_WARN("DBus Error finding adapter:", e.getMessage());
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 }
 
-void BluezClient::start_scanning() {
-    if (adapter_path.empty())
+void BluezClient::setup_adapter_watch() {
+    const std::string matchRule =
+        "type='signal',sender='" + BLUEZ_SERVICE + "',interface='" + MGR_IFACE + "'";
+
+    interfaces_match_slot = connection->addMatch(
+        matchRule,
+        [this](sdbus::Message msg) {
+            std::string member = msg.getMemberName();
+            sdbus::ObjectPath path;
+
+            try {
+                if (member == "InterfacesAdded") {
+                    ObjectCache::Interfaces interfaces;
+                    msg >> path >> interfaces;
+                    cache.add_interfaces(path, interfaces);
+
+                    if (!interfaces.count(ADAPTER_IFACE))
+                        return;
+
+                    LOG_INFO("Adapter added:", path);
+
+                    start_scanning();
+                    update_adapter_state();
+                } else if (member == "InterfacesRemoved") {
+                    std::vector<std::string> interfaces;
+                    msg >> path >> interfaces;
+                    cache.remove_interfaces(path, interfaces);
+
+                    if (std::find(interfaces.begin(), interfaces.end(), ADAPTER_IFACE) ==
+                        interfaces.end())
+                        return;
+
+                    scanning.erase(path);
+                    LOG_INFO("Adapter removed:", path);
+
+                    // Fall back to whatever adapters are left
+                    start_scanning();
+                    update_adapter_state();
+                }
+            } catch (const sdbus::Error &e) {
+                LOG_DEBUG("Error parsing signal:", e.getMessage());
+            }
+        },
+        sdbus::return_slot);
+}
+
+void BluezClient::on_adapter_changed(const std::string &path,
+                                     const std::map<std::string, sdbus::Variant> &changed) {
+    auto it = changed.find("Powered");
+    if (it == changed.end())
+        return;
+
+    bool powered = it->second.get<bool>();
+    LOG_INFO("Adapter powered:", path, powered);
+
+    if (powered && !scanning.count(path)) {
+        // BlueZ drops the discovery session on power off, so ask again right away
+        start_scanning(path);
+    } else if (!powered) {
+        scanning.erase(path);
+    }
+    update_adapter_state();
+}
+
+void BluezClient::update_adapter_state() {
+    state.set_adapter_powered(cache.any_adapter_powered());
+    state.print_json();
+}
+
+void BluezClient::on_manufacturer_data(const std::string &path, std::uint16_t cid,
+                                       const std::vector<std::uint8_t> &bytes,
+                                       std::int16_t rssi) {
+    // The same advert heard by another adapter is only decoded once
+    bool is_new = deduper.accept(path, bytes, rssi);
+
+    if (Log::enabled(Log::Level::Debug) &&
+        deduper.total_received() % Config::STATS_INTERVAL == 0)
+        log_stats();
+
+    if (!is_new)
         return;
 
+    auto result = DecoderRegistry::decode(cid, bytes);
+
+    if (result) {
+        note_activity();
+        if (state.update_from_packet(*result, path)) {
+            state.print_json();
+        }
+    }
+}
+
+void BluezClient::setup_sleep_watch() {
+    const std::string matchRule = "type='signal',sender='" + LOGIN_SERVICE + "',path='" +
+                                  LOGIN_PATH + "',interface='" + LOGIN_MGR_IFACE +
+                                  "',member='PrepareForSleep'";
+
+    sleep_match_slot = connection->addMatch(
+        matchRule,
+        [this](sdbus::Message msg) {
+            bool sleeping = false;
+            try {
+                msg >> sleeping;
+            } catch (const sdbus::Error &e) {
+                LOG_DEBUG("Error parsing signal:", e.getMessage());
+                return;
+            }
+
+            LOG_INFO("PrepareForSleep", {}, sleeping);
+
+            if (sleeping) {
+                stop_scanning();
+                state.set_suspended(true);
+                state.print_json();
+                // Discovery is stopped, logind may go ahead
+                sleep_lock.reset();
+            } else {
+                take_sleep_lock();
+                state.set_suspended(false);
+                // The cache kept following BlueZ while we slept
+                state.set_connected(selected_connected());
+                state.print_json();
+                // BlueZ doesn't always resume discovery by itself, so start a fresh session.
+                // Devices may have moved while asleep: scan actively for a while.
+                idle = false;
+                last_activity = std::chrono::steady_clock::now();
+                stop_scanning();
+                start_scanning();
+            }
+        },
+        sdbus::return_slot);
+
+    take_sleep_lock();
+}
+
+void BluezClient::take_sleep_lock() {
+    // A delay inhibitor gives us time to stop discovery before the system suspends
     try {
-        auto proxy = createBluezProxy(*connection, adapter_path);
+        auto proxy = sdbus::createProxy(*connection, LOGIN_SERVICE, LOGIN_PATH);
+        proxy->callMethod("Inhibit")
+            .onInterface(LOGIN_MGR_IFACE)
+            .withArguments("sleep", "hyprpods", "Stop Bluetooth discovery", "delay")
+            .storeResultsTo(sleep_lock);
+    } catch (const sdbus::Error &e) {
+        LOG_WARN("Could not take sleep inhibitor:", e.getMessage());
+    }
+}
 
-        // Build Discovery Filter
-        std::map<std::string, sdbus::Variant> filter;
+void BluezClient::stop_scanning() {
+    for (const auto &path : scanning) {
+        try {
+            auto proxy = createBluezProxy(*connection, path);
+            proxy->callMethod("StopDiscovery").onInterface(ADAPTER_IFACE);
+        } catch (const sdbus::Error &e) {
+            LOG_WARN("Failed to stop scanning on", path);
+        }
+    }
+    scanning.clear();
+}
+
+void BluezClient::start_scanning() {
+    // Every powered adapter scans at once; the deduper merges what they report
+    for (const auto &adapter : cache.adapters()) {
+        if (adapter.powered && !scanning.count(adapter.path))
+            start_scanning(adapter.path);
+    }
+}
 
-        filter["Transport"] = sdbus::Variant(std::string("le"));
-        filter["DuplicateData"] = sdbus::Variant(true);
+void BluezClient::start_scanning(const std::string &path) {
+    try {
+        auto proxy = createBluezProxy(*connection, path);
 
-        proxy->callMethod("SetDiscoveryFilter").onInterface(ADAPTER_IFACE).withArguments(filter);
+        proxy->callMethod("SetDiscoveryFilter")
+            .onInterface(ADAPTER_IFACE)
+            .withArguments(discovery_filter(idle));
         proxy->callMethod("StartDiscovery").onInterface(ADAPTER_IFACE);
+        scanning.insert(path);
 
     } catch (const sdbus::Error &e) {
-        std::cerr << "Failed to start scanning: " << e.getMessage() << std::endl;
+        LOG_ERROR("Failed to start scanning on", path);
+        LOG_ERROR("DBus error:", e.getMessage());
+    }
+}
+
+void BluezClient::log_stats() const {
+    LOG_DEBUG("Stdout lines dropped", {}, static_cast<long long>(writer.lines_dropped()));
+    for (const auto &[path, stats] : deduper.stats()) {
+        LOG_DEBUG("Adverts received on", path, static_cast<long long>(stats.received));
+        LOG_DEBUG("Adverts deduplicated on", path, static_cast<long long>(stats.duplicates));
+        LOG_DEBUG("Strongest signal count on", path,
+                  static_cast<long long>(stats.strongest_signal));
     }
 }
 
-void BluezClient::start_signal_listener() {
+void BluezClient::setup_unix_signals() {
+    // Signals arrive through a signalfd polled by the event loop, no thread parked on them.
+    // main() blocks these in every thread before anything is started.
     sigset_t set;
     sigemptyset(&set);
     sigaddset(&set, SIGUSR1);
-    // Block in this thread so the new thread inherits the mask
+    sigaddset(&set, SIGUSR2);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGINT);
     pthread_sigmask(SIG_BLOCK, &set, nullptr);
 
-    signal_thread = std::thread([this, set]() mutable {
-        int sig;
-        while (running) {
-            // Wait for SIGUSR1
-            if (sigwait(&set, &sig) == 0 && sig == SIGUSR1) {
-                if (!running)
-                    break;
-                std::cerr << "Signal received. Spawning pairing thread..." << std::endl;
-                if (this->state.is_connected()) {
-                    std::cerr << "Device not connected. Ignoring pairing request." << std::endl;
-                } else {
-                    std::thread([this]() { this->trigger_pairing(); }).detach();
-                }
+    signal_fd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0)
+        throw std::runtime_error(std::string("signalfd failed: ") + std::strerror(errno));
+}
+
+void BluezClient::handle_unix_signals() {
+    struct signalfd_siginfo info;
+    while (::read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+        switch (info.ssi_signo) {
+        case SIGUSR1:
+            LOG_INFO("Signal received. Spawning pairing thread...");
+            if (state.is_connected()) {
+                LOG_INFO("Device not connected. Ignoring pairing request.");
+            } else {
+                trigger_pairing(state.get_pairing_mac());
             }
+            break;
+        case SIGUSR2:
+            Log::dump_recent(STDERR_FILENO);
+            break;
+        case SIGTERM:
+        case SIGINT:
+            // Leave the loop so discovery is stopped on the way out
+            running = false;
+            break;
         }
-    });
+    }
 }
 
 void BluezClient::setup_signal_handler() {
-    const std::string matchRule = "type='signal',interface='" + PROP_IFACE + "'";
+    // Only BlueZ objects, so unrelated property traffic on the bus never wakes us
+    const std::string matchRule = "type='signal',sender='" + BLUEZ_SERVICE + "',interface='" +
+                                  PROP_IFACE + "',member='PropertiesChanged'," +
+                                  "path_namespace='/org/bluez'";
 
     property_match_slot = connection->addMatch(
         matchRule,
@@ -147,20 +595,27 @@ void BluezClient::setup_signal_handler() {
             try {
                 msg >> iface >> changed >> invalidated;
             } catch (const sdbus::Error &e) {
-                if (Config::DEBUG_MODE)
-                    std::cerr << "Error parsing signal: " << e.getMessage() << std::endl;
+                LOG_DEBUG("Error parsing signal:", e.getMessage());
+                return;
+            }
+
+            cache.update_properties(obj_path, iface, changed);
+
+            if (iface == ADAPTER_IFACE) {
+                on_adapter_changed(obj_path, changed);
                 return;
             }
 
-            if (iface != DEVICE_IFACE)
+            if (iface != DEVICE_IFACE || !is_selected(obj_path))
                 return;
 
             // 1. Connection State
             if (auto it = changed.find("Connected"); it != changed.end()) {
                 bool is_conn = it->second.get<bool>();
                 state.set_connected(is_conn);
-                if (Config::DEBUG_MODE)
-                    std::cerr << "DEBUG: Connection State Changed: " << is_conn << std::endl;
+                if (is_conn)
+                    note_activity();
+                LOG_DEBUG("Connection State Changed:", obj_path, is_conn);
                 state.print_json();
             }
 
@@ -168,84 +623,58 @@ void BluezClient::setup_signal_handler() {
             if (auto it = changed.find("ManufacturerData"); it != changed.end()) {
                 auto mfg_data = it->second.get<std::map<uint16_t, sdbus::Variant>>();
 
-                if (auto mfg_it = mfg_data.find(Config::APPLE_CID); mfg_it != mfg_data.end()) {
-                    auto bytes = Utils::to_byte_vector(mfg_it->second);
-                    auto result = Decoder::parse(bytes);
+                std::int16_t rssi = AdvertDeduper::RSSI_UNKNOWN;
+                if (auto rssi_it = changed.find("RSSI"); rssi_it != changed.end())
+                    rssi = rssi_it->second.get<std::int16_t>();
 
-                    if (result) {
-                        if (state.update_from_packet(*result, obj_path)) {
-                            state.print_json();
-                        }
-                    }
+                for (const auto &[cid, value] : mfg_data) {
+                    // By now sdbus has copied every entry into a Variant; what we skip for
+                    // vendors we can't decode is the byte vector and the decoding
+                    if (DecoderRegistry::handles(cid))
+                        on_manufacturer_data(obj_path, cid, Utils::to_byte_vector(value), rssi);
                 }
             }
         },
         sdbus::return_slot);
 }
 
-void BluezClient::trigger_pairing() {
-    auto conn = sdbus::createSystemBusConnection();
-
-    const std::string &mac = state.get_pairing_mac();
-
-    std::cout << "Starting action for " << mac << "..." << std::endl;
-
-    std::string device_path;
-    bool is_paired = false;
-
-    // 1. Find Device by MAC Address
-    try {
-        auto proxy = createBluezProxy(*conn, "/");
-        std::map<sdbus::ObjectPath, std::map<std::string, std::map<std::string, sdbus::Variant>>>
-            objects;
-
-        proxy->callMethod("GetManagedObjects").onInterface(MGR_IFACE).storeResultsTo(objects);
-
-        for (const auto &[path, interfaces] : objects) {
-            if (auto it = interfaces.find(DEVICE_IFACE); it != interfaces.end()) {
-                const auto &props = it->second;
-
-                if (auto addr_it = props.find("Address"); addr_it != props.end()) {
-                    if (addr_it->second.get<std::string>() == mac) {
-                        device_path = path;
-                        if (auto paired_it = props.find("Paired"); paired_it != props.end()) {
-                            is_paired = paired_it->second.get<bool>();
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-    } catch (const sdbus::Error &e) {
-        std::cerr << "Error finding device: " << e.getMessage() << std::endl;
-        return;
-    }
-
-    if (device_path.empty()) {
-        std::cerr << "Device " << mac << " not found." << std::endl;
-        return;
-    }
-
-    // 2. Pair (if needed) and Connect
+// Runs on its own thread with its own connection, and only gets copies: it may outlive the
+// BluezClient that started it
+static void pair_device(const std::string &device_path, bool is_paired) {
     try {
+        auto conn = sdbus::createSystemBusConnection();
         auto device = createBluezProxy(*conn, device_path);
 
         if (!is_paired) {
-            std::cout << "Setting Trust..." << std::endl;
+            LOG_INFO("Setting Trust...");
             device->callMethod("Set")
                 .onInterface(PROP_IFACE)
                 .withArguments(DEVICE_IFACE, "Trusted", sdbus::Variant(true));
 
-            std::cout << "Pairing..." << std::endl;
+            LOG_INFO("Pairing...");
             device->callMethod("Pair").onInterface(DEVICE_IFACE);
         } else {
-            std::cout << "Already paired." << std::endl;
+            LOG_INFO("Already paired.");
         }
 
-        std::cout << "Connecting..." << std::endl;
+        LOG_INFO("Connecting...");
         device->callMethod("Connect").onInterface(DEVICE_IFACE);
 
     } catch (const sdbus::Error &e) {
-        std::cerr << "Operation failed: " << e.getMessage() << std::endl;
+        LOG_ERROR("Operation failed:", e.getMessage());
     }
 }
+
+void BluezClient::trigger_pairing(const std::string &mac) {
+    LOG_INFO("Starting action for", mac);
+
+    // Looked up here on the loop thread, which owns the cache
+    auto device_info = cache.find_device_by_address(mac);
+    if (!device_info) {
+        LOG_ERROR("Device not found:", mac);
+        return;
+    }
+
+    // Pair and Connect block until the device answers, so they run off the loop
+    std::thread(pair_device, device_info->path, device_info->paired).detach();
+}
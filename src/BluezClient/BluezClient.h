@@ -1,9 +1,19 @@
 #pragma once
 
+#include "../Control/CommandChannel.h"
+#include "../Output/StdoutWriter.h"
+#include "../State/AdvertDeduper.h"
 #include "../State/DeviceState.h"
+#include "ObjectCache.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
 #include <sdbus-c++/sdbus-c++.h>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class BluezClient {
 public:
@@ -12,21 +22,55 @@ public:
 
     void run();
 
-    void trigger_pairing();
-
 private:
+    void trigger_pairing(const std::string &mac);
     void init_connection();
-    void find_adapter();
+    void run_event_loop();
+    void handle_command(const Command &cmd);
+    void select_device(std::string_view mac);
+    bool is_selected(const std::string &path) const;
+    bool selected_connected() const;
+    void dump_stats() const;
+    void load_objects();
+    void setup_adapter_watch();
+    void on_adapter_changed(const std::string &path,
+                            const std::map<std::string, sdbus::Variant> &changed);
+    void update_adapter_state();
+    void on_manufacturer_data(const std::string &path, std::uint16_t cid,
+                              const std::vector<std::uint8_t> &bytes, std::int16_t rssi);
+    void setup_sleep_watch();
+    void take_sleep_lock();
     void start_scanning();
+    void start_scanning(const std::string &path);
+    void stop_scanning();
+    void log_stats() const;
     void setup_signal_handler();
-    void start_signal_listener();
+    void setup_unix_signals();
+    void handle_unix_signals();
+    void note_activity();
+    void enter_idle();
+    void apply_scan_mode();
 
     std::unique_ptr<sdbus::IConnection> connection;
 
     sdbus::Slot property_match_slot;
+    sdbus::Slot interfaces_match_slot;
+    sdbus::Slot sleep_match_slot;
+    sdbus::UnixFd sleep_lock; // logind delay inhibitor, held while awake
 
+    StdoutWriter writer; // Must outlive state
     DeviceState state;
-    std::string adapter_path;
-    std::thread signal_thread;
-    std::atomic<bool> running{true};
+    AdvertDeduper deduper;
+    ObjectCache cache;
+    std::set<std::string> scanning; // Adapters with an active discovery session
+    CommandChannel commands;
+    std::string selected_device; // "/dev_AA_BB_..." suffix of the only device to show, or empty
+    int signal_fd = -1; // SIGUSR1/SIGUSR2/SIGTERM/SIGINT, read by the event loop
+    bool running = true;
+
+    // Idle mode: nothing relevant heard for `idle_after`
+    std::chrono::seconds idle_after;
+    bool idle = false;
+    std::chrono::steady_clock::time_point last_activity;
+    std::uint64_t loop_wakeups = 0;
 };
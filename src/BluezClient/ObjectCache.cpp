@@ -0,0 +1,168 @@
+#include "ObjectCache.h"
+#include <algorithm>
+#include <cctype>
+
+static const std::string ADAPTER_IFACE = "org.bluez.Adapter1";
+static const std::string DEVICE_IFACE = "org.bluez.Device1";
+
+// Copies a property into `out` if it is present and of the expected type
+template <typename T>
+static bool read_property(const std::map<std::string, sdbus::Variant> &props,
+                          const std::string &name, T &out) {
+    auto it = props.find(name);
+    if (it == props.end())
+        return false;
+    try {
+        out = it->second.get<T>();
+        return true;
+    } catch (const sdbus::Error &) {
+        return false;
+    }
+}
+
+static std::string normalize_address(std::string address) {
+    std::transform(address.begin(), address.end(), address.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    return address;
+}
+
+void ObjectCache::load(const ManagedObjects &objects) {
+    adapters_by_path.clear();
+    devices_by_path.clear();
+    device_paths_by_address.clear();
+
+    for (const auto &[path, interfaces] : objects) {
+        add_interfaces(path, interfaces);
+    }
+}
+
+void ObjectCache::add_interfaces(const std::string &path, const Interfaces &interfaces) {
+    if (auto it = interfaces.find(ADAPTER_IFACE); it != interfaces.end()) {
+        Adapter &adapter = adapters_by_path[path];
+        adapter.path = path;
+        read_property(it->second, "Address", adapter.address);
+        read_property(it->second, "Powered", adapter.powered);
+    }
+
+    if (auto it = interfaces.find(DEVICE_IFACE); it != interfaces.end()) {
+        Device &device = devices_by_path[path];
+        device.path = path;
+        read_property(it->second, "Paired", device.paired);
+        read_property(it->second, "Connected", device.connected);
+
+        sdbus::ObjectPath adapter;
+        if (read_property(it->second, "Adapter", adapter))
+            device.adapter = adapter;
+
+        std::string address;
+        if (read_property(it->second, "Address", address)) {
+            device.address = normalize_address(address);
+            device_paths_by_address[device.address].insert(path);
+        }
+    }
+}
+
+void ObjectCache::remove_interfaces(const std::string &path,
+                                    const std::vector<std::string> &interfaces) {
+    for (const auto &iface : interfaces) {
+        if (iface == ADAPTER_IFACE)
+            adapters_by_path.erase(path);
+        else if (iface == DEVICE_IFACE)
+            remove_device(path);
+    }
+}
+
+void ObjectCache::remove_device(const std::string &path) {
+    auto it = devices_by_path.find(path);
+    if (it == devices_by_path.end())
+        return;
+
+    // Other adapters may still have an object for the same address
+    if (auto addr_it = device_paths_by_address.find(it->second.address);
+        addr_it != device_paths_by_address.end()) {
+        addr_it->second.erase(path);
+        if (addr_it->second.empty())
+            device_paths_by_address.erase(addr_it);
+    }
+
+    devices_by_path.erase(it);
+}
+
+void ObjectCache::update_properties(const std::string &path, const std::string &iface,
+                                    const std::map<std::string, sdbus::Variant> &changed) {
+    if (iface == ADAPTER_IFACE) {
+        if (!changed.count("Powered") && !changed.count("Address"))
+            return;
+
+        Adapter &adapter = adapters_by_path[path];
+        adapter.path = path;
+        read_property(changed, "Address", adapter.address);
+        read_property(changed, "Powered", adapter.powered);
+    } else if (iface == DEVICE_IFACE) {
+        // Most device updates are RSSI/ManufacturerData, which aren't mirrored
+        if (!changed.count("Paired") && !changed.count("Connected"))
+            return;
+
+        auto it = devices_by_path.find(path);
+        if (it == devices_by_path.end())
+            return;
+        read_property(changed, "Paired", it->second.paired);
+        read_property(changed, "Connected", it->second.connected);
+    }
+}
+
+std::optional<ObjectCache::Device> ObjectCache::find_device(const std::string &path) const {
+    auto it = devices_by_path.find(path);
+    if (it == devices_by_path.end())
+        return std::nullopt;
+    return it->second;
+}
+
+std::optional<ObjectCache::Device>
+ObjectCache::find_device_by_address(const std::string &address) const {
+    auto addr_it = device_paths_by_address.find(normalize_address(address));
+    if (addr_it == device_paths_by_address.end())
+        return std::nullopt;
+
+    const Device *fallback = nullptr;
+    for (const auto &path : addr_it->second) {
+        auto it = devices_by_path.find(path);
+        if (it == devices_by_path.end())
+            continue;
+        auto adapter_it = adapters_by_path.find(it->second.adapter);
+        if (adapter_it != adapters_by_path.end() && adapter_it->second.powered)
+            return it->second;
+        if (!fallback)
+            fallback = &it->second;
+    }
+    if (fallback)
+        return *fallback;
+    return std::nullopt;
+}
+
+std::vector<ObjectCache::Adapter> ObjectCache::adapters() const {
+    std::vector<Adapter> out;
+    out.reserve(adapters_by_path.size());
+    for (const auto &[path, adapter] : adapters_by_path) {
+        out.push_back(adapter);
+    }
+    return out;
+}
+
+std::vector<ObjectCache::Device> ObjectCache::connected_devices() const {
+    std::vector<Device> out;
+    for (const auto &[path, device] : devices_by_path) {
+        if (device.connected)
+            out.push_back(device);
+    }
+    return out;
+}
+
+bool ObjectCache::any_adapter_powered() const {
+    return std::any_of(adapters_by_path.begin(), adapters_by_path.end(),
+                       [](const auto &entry) { return entry.second.powered; });
+}
+
+size_t ObjectCache::device_count() const {
+    return devices_by_path.size();
+}
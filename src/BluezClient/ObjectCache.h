@@ -0,0 +1,55 @@
+#pragma once
+#include <map>
+#include <optional>
+#include <set>
+#include <sdbus-c++/sdbus-c++.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// In-memory mirror of the BlueZ adapters and devices we care about.
+// Filled once from GetManagedObjects, then kept current from InterfacesAdded/Removed and
+// PropertiesChanged, so looking up a device or adapter never needs a bus round-trip.
+// Owned by the event loop thread: it is neither locked nor safe to use from other threads.
+class ObjectCache {
+public:
+    // InterfaceName -> PropertyName -> Variant
+    using Interfaces = std::map<std::string, std::map<std::string, sdbus::Variant>>;
+    using ManagedObjects = std::map<sdbus::ObjectPath, Interfaces>;
+
+    struct Adapter {
+        std::string path;
+        std::string address;
+        bool powered = false;
+    };
+
+    struct Device {
+        std::string path;
+        std::string address;
+        std::string adapter; // Object path of the owning adapter
+        bool paired = false;
+        bool connected = false;
+    };
+
+    void load(const ManagedObjects &objects);
+    void add_interfaces(const std::string &path, const Interfaces &interfaces);
+    void remove_interfaces(const std::string &path, const std::vector<std::string> &interfaces);
+    void update_properties(const std::string &path, const std::string &iface,
+                           const std::map<std::string, sdbus::Variant> &changed);
+
+    std::optional<Device> find_device(const std::string &path) const;
+    // BlueZ keeps one object per adapter for the same address; one on a powered adapter wins
+    std::optional<Device> find_device_by_address(const std::string &address) const;
+
+    std::vector<Adapter> adapters() const;
+    std::vector<Device> connected_devices() const;
+    bool any_adapter_powered() const;
+    size_t device_count() const;
+
+private:
+    void remove_device(const std::string &path);
+
+    std::unordered_map<std::string, Adapter> adapters_by_path;
+    std::unordered_map<std::string, Device> devices_by_path;
+    std::unordered_map<std::string, std::set<std::string>> device_paths_by_address;
+};
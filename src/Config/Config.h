@@ -12,6 +12,26 @@ const std::string MAC_FILE = "/tmp/hyprpods_last_mac";
 // How long (seconds) to keep the widget shown after closing lid
 constexpr int TIMEOUT_SECONDS = 2;
 
-// Set to TRUE to see raw packet logs in terminal
-constexpr bool DEBUG_MODE = true;
+// Without a decoded Apple advert or connection for this long (seconds), go idle:
+// discovery stops reporting repeated adverts and the event loop arms no timers
+constexpr int IDLE_AFTER_SECONDS = 30;
+
+// Environment variable overriding IDLE_AFTER_SECONDS (whole seconds, at least 1)
+constexpr const char *IDLE_AFTER_ENV = "HYPRPODS_IDLE_AFTER";
+
+// Adverts for the same device and payload seen within this window (ms) by any adapter
+// are treated as one
+constexpr int DEDUP_WINDOW_MS = 150;
+
+// At debug log level, log per-adapter stats after this many adverts
+constexpr int STATS_INTERVAL = 500;
+
+// Log records buffered between the event loop and the writer thread (power of two)
+constexpr int LOG_RING_SIZE = 1024;
+
+// Formatted log lines kept for SIGUSR2 / crash dumps
+constexpr int LOG_HISTORY = 64;
+
+// Environment variable selecting the log level: debug, info, warn, error or off
+constexpr const char *LOG_LEVEL_ENV = "HYPRPODS_LOG";
 } // namespace Config
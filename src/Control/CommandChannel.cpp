@@ -0,0 +1,91 @@
+#include "CommandChannel.h"
+#include "../Log/Log.h"
+#include <cerrno>
+#include <unistd.h>
+
+// Longest accepted command line; anything longer is dropped
+constexpr size_t MAX_LINE = 4096;
+
+CommandChannel::CommandChannel(int fd, Handler handler) : in_fd(fd), handler(std::move(handler)) {
+    // Waybar passes its own stdin through, which is a terminal if Waybar was started from one.
+    // Reading it from our background process group would stop us with SIGTTIN.
+    if (isatty(in_fd)) {
+        LOG_INFO("Command input is a terminal, not reading commands from it");
+        open = false;
+    }
+}
+
+void CommandChannel::on_readable() {
+    // A single read per wakeup, so this never blocks even if fd is in blocking mode
+    char chunk[1024];
+    ssize_t n = ::read(in_fd, chunk, sizeof(chunk));
+    if (n < 0) {
+        if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+            LOG_WARN("Command input failed, closing it");
+            open = false;
+        }
+        return;
+    }
+    if (n == 0) {
+        open = false;
+        return;
+    }
+
+    buffer.append(chunk, static_cast<size_t>(n));
+
+    size_t start = 0;
+    size_t end;
+    while ((end = buffer.find('\n', start)) != std::string::npos) {
+        if (!discarding)
+            handle_line(std::string_view(buffer).substr(start, end - start));
+        discarding = false;
+        start = end + 1;
+    }
+    buffer.erase(0, start);
+
+    if (buffer.size() > MAX_LINE) {
+        LOG_WARN("Command line too long, ignoring it");
+        buffer.clear();
+        discarding = true;
+    }
+}
+
+void CommandChannel::handle_line(std::string_view line) {
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+        return;
+
+    arena.reset();
+    const Json::Node *msg;
+    try {
+        msg = Json::Parser::parse(line, arena);
+    } catch (const std::exception &e) {
+        LOG_WARN("Invalid command:", e.what());
+        return;
+    }
+
+    std::string_view name = msg->get_string("cmd");
+    Command cmd;
+    if (name == "pair") {
+        cmd.type = Command::Type::Pair;
+    } else if (name == "rescan") {
+        cmd.type = Command::Type::Rescan;
+    } else if (name == "select") {
+        cmd.type = Command::Type::Select;
+    } else if (name == "set-rate") {
+        cmd.type = Command::Type::SetRate;
+        double interval = msg->get_number("interval_ms", -1);
+        if (interval < 0 || interval > 60000) {
+            LOG_WARN("set-rate needs interval_ms between 0 and 60000");
+            return;
+        }
+        cmd.interval_ms = static_cast<int>(interval);
+    } else if (name == "dump-stats") {
+        cmd.type = Command::Type::DumpStats;
+    } else {
+        LOG_WARN("Unknown command:", name);
+        return;
+    }
+    cmd.mac = msg->get_string("mac");
+
+    handler(cmd);
+}
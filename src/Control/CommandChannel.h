@@ -0,0 +1,42 @@
+#pragma once
+#include "../Utils/json.hpp"
+#include <functional>
+#include <string>
+#include <string_view>
+
+// One control message, e.g. {"cmd": "pair", "mac": "AA:BB:CC:DD:EE:FF"}
+struct Command {
+    enum class Type { Pair, Rescan, Select, SetRate, DumpStats };
+
+    Type type;
+    std::string_view mac; // pair, select (empty clears the selection)
+    int interval_ms = 0;  // set-rate: minimum time between output lines, 0 = unlimited
+};
+
+// Reads newline-delimited JSON commands from a file descriptor (stdin by default).
+// A terminal is never read from; commands come from a pipe or FIFO.
+// Meant to be driven by the event loop: call on_readable() when poll reports input.
+// Each line is parsed into a per-message arena, so steady-state parsing doesn't allocate.
+class CommandChannel {
+public:
+    // The Command (and the strings it points to) is only valid during the call
+    using Handler = std::function<void(const Command &)>;
+
+    CommandChannel(int fd, Handler handler);
+
+    int fd() const { return in_fd; }
+    // False once the other end has closed the input
+    bool is_open() const { return open; }
+
+    void on_readable();
+
+private:
+    void handle_line(std::string_view line);
+
+    int in_fd;
+    bool open = true;
+    bool discarding = false; // Skipping the rest of an overlong line
+    Handler handler;
+    std::string buffer;
+    Json::Arena arena;
+};
@@ -1,17 +1,55 @@
 #include "Decoder.h"
+#include <algorithm>
+#include <array>
 
 // Known Headers for AirPods Battery Packets
 constexpr std::uint8_t HEADER_FLIP = 0x07; // Standard (Gen 1/2)
 constexpr std::uint8_t HEADER_PRO = 0x19;  // Pro / Gen 3
 
-std::optional<BatteryData> Decoder::parse(const std::vector<std::uint8_t> &data) {
-    if (data.size() < 8)
-        return std::nullopt;
+// Model IDs (bytes 3-4 of the status message) of Beats products
+constexpr std::array<std::uint16_t, 10> BEATS_MODELS = {
+    0x0320, // Powerbeats3
+    0x0520, // BeatsX
+    0x0620, // Beats Solo3
+    0x0920, // Beats Studio3
+    0x0B20, // Powerbeats Pro
+    0x0C20, // Beats Solo Pro
+    0x1020, // Beats Flex
+    0x1120, // Beats Studio Buds
+    0x1220, // Beats Fit Pro
+    0x1620, // Beats Studio Buds+
+};
 
-    std::uint8_t header = data[0];
-    if (header != HEADER_FLIP && header != HEADER_PRO) {
-        return std::nullopt;
+bool Decoder::is_status_packet(const std::vector<std::uint8_t> &data) {
+    return data.size() >= 8 && (data[0] == HEADER_FLIP || data[0] == HEADER_PRO);
+}
+
+bool Decoder::is_beats_packet(const std::vector<std::uint8_t> &data) {
+    if (!is_status_packet(data))
+        return false;
+    std::uint16_t model = static_cast<std::uint16_t>((data[3] << 8) | data[4]);
+    return std::find(BEATS_MODELS.begin(), BEATS_MODELS.end(), model) != BEATS_MODELS.end();
+}
+
+std::optional<BatteryData> Decoder::parse_beats(const std::vector<std::uint8_t> &data) {
+    auto out = parse(data);
+    if (out)
+        out->vendor = Vendor::Beats;
+    return out;
+}
+
+const char *Decoder::vendor_name(Vendor vendor) {
+    switch (vendor) {
+    case Vendor::Beats:
+        return "Beats";
+    default:
+        return "AirPods";
     }
+}
+
+std::optional<BatteryData> Decoder::parse(const std::vector<std::uint8_t> &data) {
+    if (!is_status_packet(data))
+        return std::nullopt;
 
     BatteryData out;
     out.in_pairing_mode = false;
@@ -3,16 +3,30 @@
 #include <optional>
 #include <vector>
 
+enum class Vendor { Apple, Beats };
+
 struct BatteryData {
     int left = -1;
     int right = -1;
     int case_val = -1;
     bool charging = false;
     bool in_pairing_mode = false;
+    Vendor vendor = Vendor::Apple;
 };
 
+// Decoders for Apple proximity pairing messages (manufacturer data under Config::APPLE_CID).
+// They are dispatched through DecoderRegistry.
 class Decoder {
 public:
-    // Returns std::nullopt if the packet is not a valid status packet.
+    // Proximity pairing status message, from AirPods or Beats
+    static bool is_status_packet(const std::vector<std::uint8_t> &data);
+    // Status message whose model ID (bytes 3-4) is a Beats product
+    static bool is_beats_packet(const std::vector<std::uint8_t> &data);
+
+    // AirPods. Returns std::nullopt if the packet is not a valid status packet.
     static std::optional<BatteryData> parse(const std::vector<std::uint8_t> &data);
+    // Beats use the same layout as AirPods; only the reported vendor differs
+    static std::optional<BatteryData> parse_beats(const std::vector<std::uint8_t> &data);
+
+    static const char *vendor_name(Vendor vendor);
 };
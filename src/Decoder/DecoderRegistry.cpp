@@ -0,0 +1,107 @@
+#include "DecoderRegistry.h"
+#include "../Config/Config.h"
+#include <array>
+#include <cstddef>
+
+namespace {
+using Bytes = std::vector<std::uint8_t>;
+
+struct Entry {
+    std::uint16_t cid;
+    bool (*matches)(const Bytes &data);
+    std::optional<BatteryData> (*decode)(const Bytes &data);
+};
+
+// Entries with the same CID must be next to each other
+constexpr Entry DECODERS[] = {
+    {Config::APPLE_CID, Decoder::is_beats_packet, Decoder::parse_beats},
+    {Config::APPLE_CID, Decoder::is_status_packet, Decoder::parse},
+};
+constexpr size_t DECODER_COUNT = sizeof(DECODERS) / sizeof(DECODERS[0]);
+
+// One slot per CID: the run of DECODERS entries registered for it
+struct Slot {
+    std::uint16_t cid = 0;
+    std::uint8_t first = 0;
+    std::uint8_t count = 0;
+};
+
+constexpr unsigned MAX_TABLE_BITS = 8;
+
+// Fibonacci hashing; the table size is picked so that no two CIDs share a slot
+constexpr size_t slot_of(std::uint16_t cid, unsigned bits) {
+    return bits == 0 ? 0 : (static_cast<std::uint32_t>(cid) * 0x9E3779B1u) >> (32 - bits);
+}
+
+constexpr bool collides(unsigned bits) {
+    for (size_t i = 0; i < DECODER_COUNT; i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (DECODERS[i].cid != DECODERS[j].cid &&
+                slot_of(DECODERS[i].cid, bits) == slot_of(DECODERS[j].cid, bits))
+                return true;
+        }
+    }
+    return false;
+}
+
+constexpr bool grouped_by_cid() {
+    for (size_t i = 1; i < DECODER_COUNT; i++) {
+        if (DECODERS[i].cid == DECODERS[i - 1].cid)
+            continue;
+        for (size_t j = 0; j + 1 < i; j++) {
+            if (DECODERS[j].cid == DECODERS[i].cid)
+                return false;
+        }
+    }
+    return true;
+}
+
+constexpr unsigned table_bits() {
+    unsigned bits = 0;
+    while (bits < MAX_TABLE_BITS && collides(bits))
+        bits++;
+    return bits;
+}
+
+constexpr unsigned TABLE_BITS = table_bits();
+constexpr size_t TABLE_SIZE = size_t{1} << TABLE_BITS;
+
+static_assert(grouped_by_cid(), "DECODERS entries with the same CID must be adjacent");
+static_assert(!collides(TABLE_BITS), "No collision-free CID table within MAX_TABLE_BITS");
+
+constexpr std::array<Slot, TABLE_SIZE> build_table() {
+    std::array<Slot, TABLE_SIZE> table{};
+    for (size_t i = 0; i < DECODER_COUNT; i++) {
+        Slot &slot = table[slot_of(DECODERS[i].cid, TABLE_BITS)];
+        if (slot.count == 0) {
+            slot.cid = DECODERS[i].cid;
+            slot.first = static_cast<std::uint8_t>(i);
+        }
+        slot.count++;
+    }
+    return table;
+}
+
+constexpr std::array<Slot, TABLE_SIZE> TABLE = build_table();
+
+constexpr bool registered(std::uint16_t cid) {
+    const Slot &slot = TABLE[slot_of(cid, TABLE_BITS)];
+    return slot.count != 0 && slot.cid == cid;
+}
+
+static_assert(registered(Config::APPLE_CID), "Apple decoders are not reachable");
+} // namespace
+
+bool DecoderRegistry::handles(std::uint16_t cid) { return registered(cid); }
+
+std::optional<BatteryData> DecoderRegistry::decode(std::uint16_t cid, const Bytes &data) {
+    if (!registered(cid))
+        return std::nullopt;
+
+    const Slot &slot = TABLE[slot_of(cid, TABLE_BITS)];
+    for (size_t i = slot.first; i < size_t{slot.first} + slot.count; i++) {
+        if (DECODERS[i].matches(data))
+            return DECODERS[i].decode(data);
+    }
+    return std::nullopt;
+}
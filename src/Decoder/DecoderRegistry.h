@@ -0,0 +1,20 @@
+#pragma once
+#include "Decoder.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Routes ManufacturerData entries to vendor decoders by company ID (CID).
+// Each decoder is registered with its CID and a predicate on the message type; decoders
+// sharing a CID are tried in registration order, so narrower predicates come first.
+// The CID lookup table is built at compile time. Supporting another vendor means adding a
+// decoder function and one row to DECODERS in DecoderRegistry.cpp.
+class DecoderRegistry {
+public:
+    // Constant-time check, meant to run before the payload is converted into a byte vector
+    static bool handles(std::uint16_t cid);
+
+    // Result of the first decoder for `cid` whose predicate accepts `data`
+    static std::optional<BatteryData> decode(std::uint16_t cid,
+                                             const std::vector<std::uint8_t> &data);
+};
@@ -0,0 +1,370 @@
+#include "Log.h"
+#include "../Config/Config.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+namespace Log {
+std::atomic<int> threshold{static_cast<int>(Level::Info)};
+
+namespace {
+constexpr size_t DETAIL_SIZE = 64;
+constexpr size_t LINE_SIZE = 192;
+
+static_assert((Config::LOG_RING_SIZE & (Config::LOG_RING_SIZE - 1)) == 0,
+              "LOG_RING_SIZE must be a power of two");
+
+struct Record {
+    std::int64_t time_ns; // Wall clock
+    Level level;
+    const char *msg;
+    long long value;
+    std::uint8_t detail_len;
+    char detail[DETAIL_SIZE];
+};
+
+// Bounded MPMC queue (Vyukov): each slot's sequence number says whether it is free or full
+struct Slot {
+    std::atomic<size_t> seq;
+    Record record;
+};
+
+std::array<Slot, Config::LOG_RING_SIZE> ring;
+
+// Slot i starts out free for the write at position i
+struct RingInit {
+    RingInit() {
+        for (size_t i = 0; i < ring.size(); i++)
+            ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+} ring_init;
+
+alignas(64) std::atomic<size_t> head{0}; // Next slot to write
+alignas(64) std::atomic<size_t> tail{0}; // Next slot to read
+
+// Records pushed but not yet drained. The producer that moves it off zero wakes the drainer.
+// It can dip below zero while a producer has published a record but not counted it yet.
+std::atomic<std::int64_t> pending{0};
+std::atomic<std::uint64_t> dropped_records{0};
+
+int wake_fd = -1;
+std::thread drain_thread;
+std::atomic<bool> stopping{false};
+std::atomic<int> dump_fd{-1}; // Set by dump_recent(), served by the drain thread
+std::atomic<std::string *> line_out{nullptr}; // Set by write_line(), served likewise
+
+// Recent formatted lines, newest at history_next - 1. Only the drain thread touches them,
+// apart from the crash handler, which reads them as they are.
+char history[Config::LOG_HISTORY][LINE_SIZE];
+size_t history_len[Config::LOG_HISTORY];
+size_t history_next = 0;
+
+bool try_pop(Record &out) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = ring[pos & (Config::LOG_RING_SIZE - 1)];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                out = slot.record;
+                slot.seq.store(pos + Config::LOG_RING_SIZE, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Empty
+        } else {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+const char *level_name(Level level) {
+    switch (level) {
+    case Level::Debug:
+        return "DEBUG";
+    case Level::Info:
+        return "INFO";
+    case Level::Warn:
+        return "WARN";
+    case Level::Error:
+        return "ERROR";
+    default:
+        return "";
+    }
+}
+
+size_t format(const Record &r, char *buf, size_t size) {
+    std::time_t secs = static_cast<std::time_t>(r.time_ns / 1000000000);
+    int millis = static_cast<int>((r.time_ns / 1000000) % 1000);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+
+    int n = std::snprintf(buf, size, "%02d:%02d:%02d.%03d %s: %s", tm.tm_hour, tm.tm_min,
+                          tm.tm_sec, millis, level_name(r.level), r.msg);
+    if (r.detail_len > 0 && n >= 0 && static_cast<size_t>(n) < size)
+        n += std::snprintf(buf + n, size - n, " %.*s", r.detail_len, r.detail);
+    if (r.value != NO_VALUE && n >= 0 && static_cast<size_t>(n) < size)
+        n += std::snprintf(buf + n, size - n, " (%lld)", r.value);
+
+    size_t len = n < 0 ? 0 : std::min(static_cast<size_t>(n), size - 2);
+    buf[len++] = '\n';
+    buf[len] = '\0';
+    return len;
+}
+
+void write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+// Formats and writes out everything in the ring, returns how many records it took
+std::int64_t drain() {
+    // Lines are batched so a burst of records costs few write(2) calls
+    static char batch[16 * LINE_SIZE];
+    size_t batch_len = 0;
+    std::int64_t count = 0;
+    Record r;
+    while (try_pop(r)) {
+        count++;
+        size_t slot = history_next % Config::LOG_HISTORY;
+        history_len[slot] = format(r, history[slot], LINE_SIZE);
+        history_next++;
+        std::memcpy(batch + batch_len, history[slot], history_len[slot]);
+        batch_len += history_len[slot];
+        if (batch_len > sizeof(batch) - LINE_SIZE) {
+            write_all(STDERR_FILENO, batch, batch_len);
+            batch_len = 0;
+        }
+    }
+    write_all(STDERR_FILENO, batch, batch_len);
+    return count;
+}
+
+void write_history(int fd) {
+    size_t count = std::min(history_next, static_cast<size_t>(Config::LOG_HISTORY));
+    for (size_t i = history_next - count; i < history_next; i++) {
+        size_t slot = i % Config::LOG_HISTORY;
+        write_all(fd, history[slot], history_len[slot]);
+    }
+}
+
+void write_dump(int fd) {
+    static const char header[] = "--- recent log records ---\n";
+    write_all(fd, header, sizeof(header) - 1);
+    write_history(fd);
+}
+
+void drain_loop() {
+    while (true) {
+        std::uint64_t wakeups;
+        if (::read(wake_fd, &wakeups, sizeof(wakeups)) < 0 && errno == EINTR)
+            continue;
+
+        // Producers count a record only after publishing it, so a positive count left over
+        // means published records still in the ring. Below zero, we took records whose
+        // producers haven't counted them yet; no need to wait for them, as the producer that
+        // next moves the count off zero wakes us.
+        while (true) {
+            std::int64_t n = drain();
+            if (pending.fetch_sub(n, std::memory_order_acq_rel) <= n)
+                break;
+        }
+
+        if (int fd = dump_fd.exchange(-1, std::memory_order_acq_rel); fd >= 0)
+            write_dump(fd);
+
+        if (std::unique_ptr<std::string> line{line_out.exchange(nullptr)})
+            write_all(STDERR_FILENO, line->data(), line->size());
+
+        if (stopping.load(std::memory_order_acquire))
+            return;
+    }
+}
+
+// Async-signal-safe formatting for the crash path: no snprintf, no localtime
+void append(char *buf, size_t &len, const char *s, size_t n) {
+    n = std::min(n, LINE_SIZE - 1 - len);
+    std::memcpy(buf + len, s, n);
+    len += n;
+}
+
+void append_number(char *buf, size_t &len, long long value) {
+    char digits[24];
+    size_t n = 0;
+    unsigned long long v = value < 0 ? 0ull - static_cast<unsigned long long>(value)
+                                     : static_cast<unsigned long long>(value);
+    do {
+        digits[sizeof(digits) - ++n] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0)
+        digits[sizeof(digits) - ++n] = '-';
+    append(buf, len, digits + sizeof(digits) - n, n);
+}
+
+// Records still waiting in the ring, oldest first. Slots a producer hasn't finished
+// writing are skipped.
+void write_queued(int fd) {
+    size_t end = head.load(std::memory_order_acquire);
+    for (size_t pos = tail.load(std::memory_order_acquire); pos != end; pos++) {
+        const Slot &slot = ring[pos & (Config::LOG_RING_SIZE - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+            continue;
+
+        const Record &r = slot.record;
+        char line[LINE_SIZE];
+        size_t len = 0;
+        const char *level = level_name(r.level);
+        append(line, len, level, std::strlen(level));
+        append(line, len, ": ", 2);
+        append(line, len, r.msg, std::strlen(r.msg));
+        if (r.detail_len > 0) {
+            append(line, len, " ", 1);
+            append(line, len, r.detail, r.detail_len);
+        }
+        if (r.value != NO_VALUE) {
+            append(line, len, " (", 2);
+            append_number(line, len, r.value);
+            append(line, len, ")", 1);
+        }
+        line[len++] = '\n';
+        write_all(fd, line, len);
+    }
+}
+
+void crash_handler(int sig) {
+    // Best effort: no locking, only write(2). Formatted history first, then whatever
+    // the drain thread hadn't got to yet, which is usually the most recent part.
+    static const char header[] = "hyprpods crashed, recent log records:\n";
+    write_all(STDERR_FILENO, header, sizeof(header) - 1);
+    write_history(STDERR_FILENO);
+    write_queued(STDERR_FILENO);
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+} // namespace
+
+void write(Level level, const char *msg, std::string_view detail, long long value) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+        slot = &ring[pos & (Config::LOG_RING_SIZE - 1)];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            dropped_records.fetch_add(1, std::memory_order_relaxed);
+            return; // Full
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record &r = slot->record;
+    r.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    r.level = level;
+    r.msg = msg;
+    r.value = value;
+    r.detail_len = static_cast<std::uint8_t>(std::min(detail.size(), DETAIL_SIZE));
+    if (r.detail_len)
+        std::memcpy(r.detail, detail.data(), r.detail_len);
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (pending.fetch_add(1, std::memory_order_acq_rel) == 0 && wake_fd >= 0)
+        eventfd_write(wake_fd, 1);
+}
+
+Level parse_level(const char *name, Level fallback) {
+    if (!name)
+        return fallback;
+    if (std::strcmp(name, "debug") == 0)
+        return Level::Debug;
+    if (std::strcmp(name, "info") == 0)
+        return Level::Info;
+    if (std::strcmp(name, "warn") == 0)
+        return Level::Warn;
+    if (std::strcmp(name, "error") == 0)
+        return Level::Error;
+    if (std::strcmp(name, "off") == 0)
+        return Level::Off;
+    return fallback;
+}
+
+void init(Level level) {
+    threshold.store(static_cast<int>(level), std::memory_order_relaxed);
+    wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0)
+        return;
+
+    // The drain thread must not take signals meant for the main thread
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    drain_thread = std::thread(drain_loop);
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    // Anything logged before the drain thread existed
+    if (pending.load(std::memory_order_acquire) > 0)
+        eventfd_write(wake_fd, 1);
+}
+
+void shutdown() {
+    if (!drain_thread.joinable())
+        return;
+    stopping.store(true, std::memory_order_release);
+    eventfd_write(wake_fd, 1);
+    drain_thread.join();
+    close(wake_fd);
+    wake_fd = -1;
+}
+
+void dump_recent(int fd) {
+    if (!drain_thread.joinable()) {
+        write_dump(fd);
+        return;
+    }
+    // The drain thread writes it, so a slow stderr never stalls the caller
+    dump_fd.store(fd, std::memory_order_release);
+    eventfd_write(wake_fd, 1);
+}
+
+void write_line(std::string line) {
+    if (!drain_thread.joinable()) {
+        write_all(STDERR_FILENO, line.data(), line.size());
+        return;
+    }
+    // A line the drain thread hasn't taken yet is superseded
+    std::unique_ptr<std::string> old{line_out.exchange(new std::string(std::move(line)))};
+    eventfd_write(wake_fd, 1);
+}
+
+void install_crash_handler() {
+    for (int sig : {SIGSEGV, SIGBUS, SIGFPE, SIGABRT}) {
+        std::signal(sig, crash_handler);
+    }
+}
+
+std::uint64_t dropped() { return dropped_records.load(std::memory_order_relaxed); }
+} // namespace Log
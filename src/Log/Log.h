@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Leveled logger that never blocks the caller.
+// Records are pushed into a lock-free ring and formatted/written to stderr by a drain thread.
+// The last Config::LOG_HISTORY lines are kept and dumped on SIGUSR2 or on a crash.
+namespace Log {
+enum class Level : int { Debug = 0, Info, Warn, Error, Off };
+
+constexpr long long NO_VALUE = LLONG_MIN;
+
+// Records below this level are skipped by the LOG_* macros with a single branch
+extern std::atomic<int> threshold;
+
+inline bool enabled(Level level) {
+    return static_cast<int>(level) >= threshold.load(std::memory_order_relaxed);
+}
+
+// Queues one record. `msg` must be a string literal, it is only formatted at drain time.
+// `detail` is copied (and truncated if long). Drops the record if the ring is full.
+void write(Level level, const char *msg, std::string_view detail = {},
+           long long value = NO_VALUE);
+
+// Parses "debug", "info", "warn", "error" or "off". Returns `fallback` for anything else.
+Level parse_level(const char *name, Level fallback);
+
+// Starts the drain thread
+void init(Level level);
+// Writes everything still queued and stops the drain thread
+void shutdown();
+
+// Has the drain thread write the most recent formatted records to `fd`; returns at once.
+// Without a drain thread (before init) they are written directly.
+void dump_recent(int fd);
+// Has the drain thread write a preformatted line (e.g. a JSON stats dump) to stderr, after
+// the records queued before it; returns at once. Only the newest unwritten line is kept.
+// Without a drain thread it is written directly.
+void write_line(std::string line);
+// On SIGSEGV/SIGBUS/SIGFPE/SIGABRT, dump the recent records to stderr before dying,
+// including those still queued for the drain thread
+void install_crash_handler();
+
+std::uint64_t dropped();
+} // namespace Log
+
+#define LOG_AT(level, ...)                                                                         \
+    do {                                                                                           \
+        if (Log::enabled(level))                                                                   \
+            Log::write(level, __VA_ARGS__);                                                        \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(Log::Level::Debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(Log::Level::Info, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(Log::Level::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(Log::Level::Error, __VA_ARGS__)
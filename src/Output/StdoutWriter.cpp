@@ -0,0 +1,101 @@
+#include "StdoutWriter.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+StdoutWriter::StdoutWriter(int fd) : out_fd(fd) {
+    // Only pipes and sockets go non-blocking. A terminal is shared with the shell,
+    // and a regular file never blocks anyway.
+    struct stat st;
+    if (fstat(out_fd, &st) != 0 || !(S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode)))
+        return;
+
+    int flags = fcntl(out_fd, F_GETFL);
+    if (flags < 0 || (flags & O_NONBLOCK))
+        return;
+
+    if (fcntl(out_fd, F_SETFL, flags | O_NONBLOCK) == 0)
+        saved_flags = flags;
+}
+
+StdoutWriter::~StdoutWriter() {
+    if (saved_flags >= 0)
+        fcntl(out_fd, F_SETFL, saved_flags);
+}
+
+void StdoutWriter::write_line(std::string line) {
+    if (closed) {
+        dropped++;
+        return;
+    }
+    line.push_back('\n');
+
+    if (current.empty()) {
+        current = std::move(line);
+        offset = 0;
+        flush();
+        return;
+    }
+
+    // Something is still pending, the new line supersedes whatever wasn't started yet.
+    // A partially written line has to be finished first to keep the output line-framed.
+    if (offset == 0) {
+        current = std::move(line);
+        dropped++;
+    } else {
+        if (!next.empty())
+            dropped++;
+        next = std::move(line);
+    }
+}
+
+int StdoutWriter::timeout_ms() const {
+    auto now = Clock::now();
+    if (!throttled(now))
+        return -1;
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(last_start + min_interval - now);
+    return static_cast<int>(wait.count());
+}
+
+void StdoutWriter::flush() {
+    while (!current.empty()) {
+        Clock::time_point now;
+        if (offset == 0 && min_interval.count() > 0) {
+            now = Clock::now();
+            if (throttled(now))
+                return;
+        }
+
+        ssize_t n = ::write(out_fd, current.data() + offset, current.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            // EPIPE: the reader is gone. Anything else is just as final.
+            close();
+            return;
+        }
+
+        if (offset == 0)
+            last_start = now;
+        offset += static_cast<size_t>(n);
+        if (offset < current.size())
+            return;
+
+        written++;
+        current = std::move(next);
+        next.clear();
+        offset = 0;
+    }
+}
+
+void StdoutWriter::close() {
+    // Nothing we hold or get later can be delivered
+    if (!current.empty())
+        dropped += next.empty() ? 1 : 2;
+    current.clear();
+    next.clear();
+    offset = 0;
+    closed = true;
+}
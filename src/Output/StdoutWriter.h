@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+
+// Writes newline-terminated lines to stdout (normally the pipe to Waybar) without blocking.
+// Each line goes out in a single write(2). When the reader falls behind, only the newest
+// pending line is kept and the ones it supersedes are dropped, so the event loop never
+// stalls on a reader that stopped reading.
+// An optional minimum interval between lines coalesces bursts the same way.
+// O_NONBLOCK is set on the open file, not just on our fd: with `2>&1` into the same pipe
+// stderr turns non-blocking as well, and the logger drops what it can't write at once.
+// Once the reader is gone (EPIPE, which needs SIGPIPE ignored) the writer stays closed.
+class StdoutWriter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StdoutWriter(int fd = STDOUT_FILENO);
+    ~StdoutWriter();
+
+    StdoutWriter(const StdoutWriter &) = delete;
+    StdoutWriter &operator=(const StdoutWriter &) = delete;
+
+    // Queues `line` (without the trailing newline) and tries to write it immediately
+    void write_line(std::string line);
+
+    // Call when fd() is writable again or timeout_ms() has expired
+    void flush();
+    // Call when poll() reports POLLERR on fd(): the reader is gone
+    void close();
+
+    // Lines are started at most once per `interval` (0 = no limit)
+    void set_min_interval(std::chrono::milliseconds interval) { min_interval = interval; }
+
+    bool has_pending() const { return !current.empty(); }
+    // True while a line is waiting for the fd to become writable
+    bool wants_write() const { return has_pending() && !throttled(Clock::now()); }
+    // Milliseconds until a throttled line may be written, -1 if nothing is waiting on the rate
+    int timeout_ms() const;
+    int fd() const { return out_fd; }
+    // True once the reader has gone away; nothing is written after that
+    bool is_closed() const { return closed; }
+
+    std::uint64_t lines_written() const { return written; }
+    std::uint64_t lines_dropped() const { return dropped; }
+
+private:
+    bool throttled(Clock::time_point now) const {
+        return has_pending() && offset == 0 && now < last_start + min_interval;
+    }
+
+    int out_fd;
+    int saved_flags = -1; // Original fd flags, restored on destruction
+    bool closed = false;
+
+    std::string current; // Line being written
+    size_t offset = 0;   // Bytes of `current` already written
+    std::string next;    // Newest line queued behind a partially written one
+
+    std::chrono::milliseconds min_interval{0};
+    Clock::time_point last_start; // When the last line started going out
+
+    std::uint64_t written = 0;
+    std::uint64_t dropped = 0;
+};
@@ -0,0 +1,84 @@
+#include "AdvertDeduper.h"
+#include <string_view>
+
+// Forget adverts once the table grows past this and they are out of the window
+constexpr std::size_t PRUNE_THRESHOLD = 256;
+
+// Packs the hex digits of "dev_AA_BB_CC_DD_EE_FF" into an integer so lookups don't allocate.
+static std::uint64_t address_key(std::string_view address) {
+    std::uint64_t key = 0;
+    for (char c : address) {
+        int nibble;
+        if (c >= '0' && c <= '9')
+            nibble = c - '0';
+        else if (c >= 'A' && c <= 'F')
+            nibble = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f')
+            nibble = c - 'a' + 10;
+        else
+            continue;
+        key = (key << 4) | static_cast<std::uint64_t>(nibble);
+    }
+    return key;
+}
+
+AdvertDeduper::AdvertDeduper(std::chrono::milliseconds window) : window(window) {}
+
+bool AdvertDeduper::accept(const std::string &device_path,
+                           const std::vector<std::uint8_t> &payload, std::int16_t rssi,
+                           Clock::time_point now) {
+    std::string_view path(device_path);
+    std::string_view adapter = path;
+    std::string_view address;
+    if (size_t pos = path.rfind("/dev_"); pos != std::string_view::npos) {
+        adapter = path.substr(0, pos);
+        address = path.substr(pos + 5);
+    }
+
+    auto stats_it = adapter_stats.find(adapter);
+    if (stats_it == adapter_stats.end())
+        stats_it = adapter_stats.emplace(std::string(adapter), AdapterStats{}).first;
+    AdapterStats &stats = stats_it->second;
+
+    stats.received++;
+    received++;
+
+    std::size_t hash = std::hash<std::string_view>{}(
+        std::string_view(reinterpret_cast<const char *>(payload.data()), payload.size()));
+
+    Entry &entry = recent[address_key(address)];
+    bool duplicate = entry.best_adapter != nullptr && entry.payload_hash == hash &&
+                     now - entry.first_seen < window;
+
+    if (duplicate) {
+        stats.duplicates++;
+        if (rssi != RSSI_UNKNOWN && rssi > entry.best_rssi && entry.best_adapter != &stats) {
+            entry.best_adapter->strongest_signal--;
+            stats.strongest_signal++;
+            entry.best_adapter = &stats;
+        }
+        if (rssi > entry.best_rssi)
+            entry.best_rssi = rssi;
+        return false;
+    }
+
+    entry.payload_hash = hash;
+    entry.first_seen = now;
+    entry.best_rssi = rssi;
+    entry.best_adapter = &stats;
+    stats.forwarded++;
+    stats.strongest_signal++;
+
+    if (recent.size() > PRUNE_THRESHOLD)
+        prune(now);
+    return true;
+}
+
+void AdvertDeduper::prune(Clock::time_point now) {
+    for (auto it = recent.begin(); it != recent.end();) {
+        if (now - it->second.first_seen >= window)
+            it = recent.erase(it);
+        else
+            ++it;
+    }
+}
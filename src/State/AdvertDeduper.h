@@ -0,0 +1,53 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Collapses the same advert reported by several adapters into a single one.
+// An advert is identified by the device address and its payload. Copies that arrive
+// within the dedup window are dropped, but still count towards the per-adapter stats
+// and move the "strongest signal" credit to whichever adapter heard it loudest.
+class AdvertDeduper {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::int16_t RSSI_UNKNOWN = std::numeric_limits<std::int16_t>::min();
+
+    struct AdapterStats {
+        std::uint64_t received = 0;         // Adverts reported by this adapter
+        std::uint64_t forwarded = 0;        // Adverts passed on to the decoder
+        std::uint64_t duplicates = 0;       // Copies of an advert that was already forwarded
+        std::uint64_t strongest_signal = 0; // Adverts this adapter heard loudest (a count)
+    };
+    // Keyed by adapter object path
+    using StatsMap = std::map<std::string, AdapterStats, std::less<>>;
+
+    explicit AdvertDeduper(std::chrono::milliseconds window);
+
+    // Returns true if the advert is new and should be decoded.
+    // `device_path` is the BlueZ object path, e.g. /org/bluez/hci0/dev_AA_BB_CC_DD_EE_FF
+    bool accept(const std::string &device_path, const std::vector<std::uint8_t> &payload,
+                std::int16_t rssi, Clock::time_point now = Clock::now());
+
+    const StatsMap &stats() const { return adapter_stats; }
+    std::uint64_t total_received() const { return received; }
+
+private:
+    struct Entry {
+        std::size_t payload_hash = 0;
+        Clock::time_point first_seen;
+        std::int16_t best_rssi = RSSI_UNKNOWN;
+        AdapterStats *best_adapter = nullptr;
+    };
+
+    void prune(Clock::time_point now);
+
+    std::chrono::milliseconds window;
+    std::unordered_map<std::uint64_t, Entry> recent; // Keyed by device address
+    StatsMap adapter_stats;
+    std::uint64_t received = 0;
+};
@@ -1,9 +1,9 @@
 #include "DeviceState.h"
 #include "../Config/Config.h"
+#include "../Log/Log.h"
 #include <algorithm>
-#include <iostream>
 
-DeviceState::DeviceState() { j = Json::Object{}; }
+DeviceState::DeviceState(StdoutWriter &out) : out(out) { j = Json::Object{}; }
 
 void DeviceState::save_mac(const std::string &path) {
     size_t pos = path.find("dev_");
@@ -25,6 +25,7 @@ bool DeviceState::update_from_packet(const BatteryData &data, const std::string
     }
 
     if (data.in_pairing_mode) {
+        bat.vendor = data.vendor;
         set_pairing_available(true, path);
         return true;
     }
@@ -47,6 +48,16 @@ void DeviceState::set_connected(bool is_connected) {
 
 void DeviceState::set_adapter_powered(bool is_on) { adapter_powered = is_on; }
 
+void DeviceState::set_suspended(bool is_suspended) {
+    suspended = is_suspended;
+    if (suspended) {
+        bat = BatteryData{};
+        connected = false;
+        pairing_available = false;
+        last_seen = {};
+    }
+}
+
 void DeviceState::set_pairing_available(bool available, const std::string &path) {
     if (available && !path.empty()) {
         save_mac(path);
@@ -56,7 +67,7 @@ void DeviceState::set_pairing_available(bool available, const std::string &path)
 }
 
 bool DeviceState::is_stale() const {
-    if (!adapter_powered)
+    if (!adapter_powered || suspended)
         return true;
     if (connected)
         return false;
@@ -66,16 +77,23 @@ bool DeviceState::is_stale() const {
     return diff > Config::TIMEOUT_SECONDS;
 }
 
+std::optional<std::chrono::steady_clock::time_point> DeviceState::hide_deadline() const {
+    if (!was_visible || connected || !adapter_powered || suspended)
+        return std::nullopt;
+    // is_stale() compares whole seconds, so it flips one second after TIMEOUT_SECONDS
+    return last_seen + std::chrono::seconds(Config::TIMEOUT_SECONDS + 1);
+}
+
 void DeviceState::print_json(bool initial) {
     if (initial) {
         j["text"] = "";
-        std::cout << j.dump() << std::endl;
+        out.write_line(j.dump());
         return;
     }
     if (is_stale()) {
         if (was_visible) {
             j["text"] = "";
-            std::cout << j.dump() << std::endl;
+            out.write_line(j.dump());
             was_visible = false;
         }
         return;
@@ -86,8 +104,9 @@ void DeviceState::print_json(bool initial) {
     if (pairing_available && !connected) {
         j["text"] = " Click to Pair";
         j["class"] = "pairing";
-        j["tooltip"] = "AirPods in pairing mode detected.\nClick to connect.";
-        std::cout << pairing_mac << std::endl;
+        j["tooltip"] = std::string(Decoder::vendor_name(bat.vendor)) +
+                       " in pairing mode detected.\nClick to connect.";
+        LOG_DEBUG("Pairing available for", pairing_mac);
     } else {
         j["text"] = "  L:" + (bat.left >= 0 ? std::to_string(bat.left) + "%" : "--") + " " +
                     "R:" + (bat.right >= 0 ? std::to_string(bat.right) + "%" : "--") +
@@ -100,5 +119,5 @@ void DeviceState::print_json(bool initial) {
                        "\n" + (bat.charging ? "Charging" : "Not Charging");
         j["class"] = connected ? "connected" : "discovered";
     }
-    std::cout << j.dump() << std::endl;
+    out.write_line(j.dump());
 }
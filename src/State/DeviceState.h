@@ -1,18 +1,23 @@
 #pragma once
 #include "../Decoder/Decoder.h"
+#include "../Output/StdoutWriter.h"
 #include "../Utils/json.hpp"
 #include <chrono>
+#include <optional>
 #include <string>
 
 class DeviceState {
 public:
-    DeviceState();
+    explicit DeviceState(StdoutWriter &out);
 
     // Core Updates
     // Returns true if UI needs update
     bool update_from_packet(const BatteryData &data, const std::string &path);
     void set_connected(bool is_connected);
     void set_adapter_powered(bool is_on);
+    // Hides output across system suspend and forgets the last reading and connection state;
+    // after resume, set_connected() must be told whether the device is still connected
+    void set_suspended(bool is_suspended);
 
     // Pairing Logic
     void set_pairing_available(bool available, const std::string &mac = "");
@@ -20,6 +25,8 @@ public:
     // Output
     void print_json(bool initial = false);
     bool is_connected() const { return connected; }
+    // When the shown widget goes stale and should be hidden, if it is shown at all
+    std::optional<std::chrono::steady_clock::time_point> hide_deadline() const;
 
     const std::string &get_pairing_mac() { return pairing_mac; }
 
@@ -31,6 +38,7 @@ private:
     BatteryData bat;
     bool connected = false;
     bool adapter_powered = false;
+    bool suspended = false;
 
     // Pairing State
     bool pairing_available = false;
@@ -40,5 +48,6 @@ private:
     std::chrono::steady_clock::time_point last_seen;
     bool was_visible = false;
 
+    StdoutWriter &out;
     Json::Value j;
 };
@@ -2,9 +2,13 @@
 
 #include <algorithm>
 #include <charconv> // For efficient number parsing
+#include <cmath>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <new>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -53,41 +57,92 @@ struct Value {
     }
 
     std::string dump() const {
-        return std::visit(
-            [](auto &&arg) -> std::string {
+        std::string s;
+        dump_to(s);
+        return s;
+    }
+
+    // Appends the serialized value to `out`, so a whole document is built in one buffer
+    void dump_to(std::string &out) const {
+        std::visit(
+            [&out](auto &&arg) {
                 using T = std::decay_t<decltype(arg)>;
                 if constexpr (std::is_same_v<T, Null>)
-                    return "null";
+                    out += "null";
                 else if constexpr (std::is_same_v<T, Bool>)
-                    return arg ? "true" : "false";
+                    out += arg ? "true" : "false";
                 else if constexpr (std::is_same_v<T, Number>)
-                    return std::to_string(arg);
+                    dump_number(out, arg);
                 else if constexpr (std::is_same_v<T, String>)
-                    return "\"" + arg + "\"";
+                    dump_string(out, arg);
                 else if constexpr (std::is_same_v<T, Array>) {
-                    std::string s = "[";
+                    out += '[';
                     for (size_t i = 0; i < arg.size(); ++i) {
-                        s += arg[i].dump();
+                        arg[i].dump_to(out);
                         if (i < arg.size() - 1)
-                            s += ", ";
+                            out += ", ";
                     }
-                    s += "]";
-                    return s;
+                    out += ']';
                 } else if constexpr (std::is_same_v<T, Object>) {
-                    std::string s = "{";
+                    out += '{';
                     auto it = arg.begin();
                     while (it != arg.end()) {
-                        s += "\"" + it->first + "\": " + it->second.dump();
+                        dump_string(out, it->first);
+                        out += ": ";
+                        it->second.dump_to(out);
                         if (++it != arg.end())
-                            s += ", ";
+                            out += ", ";
                     }
-                    s += "}";
-                    return s;
+                    out += '}';
                 }
-                return "";
             },
             data);
     }
+
+private:
+    // Integral values (counters, percentages) without a fractional part
+    static void dump_number(std::string &out, double d) {
+        constexpr double EXACT = 9007199254740992.0; // 2^53, beyond it doubles skip integers
+        if (d == std::floor(d) && std::fabs(d) <= EXACT)
+            out += std::to_string(static_cast<long long>(d));
+        else
+            out += std::to_string(d);
+    }
+
+    // Quotes and escapes a string. Control characters must be escaped, otherwise a "\n"
+    // in a tooltip would split the document across two lines.
+    static void dump_string(std::string &out, std::string_view str) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        out += '"';
+        for (char c : str) {
+            switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += HEX[(c >> 4) & 0x0F];
+                    out += HEX[c & 0x0F];
+                } else {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
 };
 
 enum class TokenType {
@@ -109,6 +164,90 @@ enum class TokenType {
 struct Token {
     TokenType type;
     std::string_view value;
+    bool has_escapes = false; // String token containing backslash escapes
+};
+
+// Bump allocator backing one parsed message. Nodes are never freed individually;
+// reset() makes the whole arena reusable for the next message, keeping its regular blocks.
+class Arena {
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<std::unique_ptr<char[]>> large; // Oversize allocations, one block each
+    size_t block_size;
+    size_t current = 0; // Index of the block being filled
+    size_t used = 0;    // Bytes used in the current block
+
+public:
+    explicit Arena(size_t block_size = 2048) : block_size(block_size) {}
+
+    void *allocate(size_t size, size_t align) {
+        while (true) {
+            if (current < blocks.size()) {
+                size_t offset = (used + align - 1) & ~(align - 1);
+                if (offset + size <= block_size) {
+                    used = offset + size;
+                    return blocks[current].get() + offset;
+                }
+                if (used > 0) {
+                    // Move on to the next block
+                    current++;
+                    used = 0;
+                    continue;
+                }
+            }
+            if (size > block_size) {
+                // Too big to share a block: it gets one of its own, freed on reset()
+                large.emplace_back(new char[size]);
+                return large.back().get();
+            }
+            blocks.emplace_back(new char[block_size]);
+            current = blocks.size() - 1;
+            used = 0;
+        }
+    }
+
+    template <typename T> T *make() { return new (allocate(sizeof(T), alignof(T))) T(); }
+
+    void reset() {
+        current = 0;
+        used = 0;
+        large.clear();
+    }
+};
+
+enum class Type { Null, Bool, Number, String, Array, Object };
+
+// Read-only parse tree allocated from an Arena. Strings point into the input buffer unless
+// they contained escapes, in which case the decoded copy lives in the arena. Both the
+// input and the arena must outlive the nodes.
+struct Node {
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string_view string;
+    std::string_view key;  // Set on object members
+    Node *first = nullptr; // First element or member
+    Node *next = nullptr;  // Next sibling in the parent array/object
+    size_t size = 0;       // Number of elements or members
+
+    const Node *find(std::string_view name) const {
+        if (type != Type::Object)
+            return nullptr;
+        for (const Node *n = first; n; n = n->next) {
+            if (n->key == name)
+                return n;
+        }
+        return nullptr;
+    }
+
+    std::string_view get_string(std::string_view name, std::string_view fallback = {}) const {
+        const Node *n = find(name);
+        return n && n->type == Type::String ? n->string : fallback;
+    }
+
+    double get_number(std::string_view name, double fallback = 0) const {
+        const Node *n = find(name);
+        return n && n->type == Type::Number ? n->number : fallback;
+    }
 };
 
 class Scanner {
@@ -168,11 +307,19 @@ private:
 
     Token scanString() {
         size_t start = cursor;
+        bool escapes = false;
         cursor++; // Skip open quote
         while (cursor < input.size()) {
-            if (input[cursor] == '"' && input[cursor - 1] != '\\') {
+            char c = input[cursor];
+            if (c == '\\') {
+                // Skip the escaped character, so \\" ends the string but \" does not
+                escapes = true;
+                cursor += 2;
+                continue;
+            }
+            if (c == '"') {
                 cursor++; // Skip close quote
-                return {TokenType::String, input.substr(start, cursor - start)};
+                return {TokenType::String, input.substr(start, cursor - start), escapes};
             }
             cursor++;
         }
@@ -208,20 +355,125 @@ private:
     }
 };
 
+// Decodes the body of a string token (without quotes) into `out`, which must have room for
+// raw.size() bytes. Returns the decoded length.
+inline size_t unescape(std::string_view raw, char *out) {
+    auto hex4 = [&raw](size_t pos) -> unsigned {
+        if (pos + 4 > raw.size())
+            throw std::runtime_error("Bad unicode escape");
+        unsigned v = 0;
+        auto res = std::from_chars(raw.data() + pos, raw.data() + pos + 4, v, 16);
+        if (res.ptr != raw.data() + pos + 4)
+            throw std::runtime_error("Bad unicode escape");
+        return v;
+    };
+
+    size_t n = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        char c = raw[i];
+        if (c != '\\') {
+            out[n++] = c;
+            continue;
+        }
+        if (++i >= raw.size())
+            throw std::runtime_error("Bad escape");
+
+        switch (raw[i]) {
+        case '"':
+        case '\\':
+        case '/':
+            out[n++] = raw[i];
+            break;
+        case 'b':
+            out[n++] = '\b';
+            break;
+        case 'f':
+            out[n++] = '\f';
+            break;
+        case 'n':
+            out[n++] = '\n';
+            break;
+        case 'r':
+            out[n++] = '\r';
+            break;
+        case 't':
+            out[n++] = '\t';
+            break;
+        case 'u': {
+            unsigned cp = hex4(i + 1);
+            i += 4;
+            // Surrogate pair
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 2 < raw.size() && raw[i + 1] == '\\' &&
+                raw[i + 2] == 'u') {
+                unsigned low = hex4(i + 3);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+            // UTF-8 encode
+            if (cp < 0x80) {
+                out[n++] = static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                out[n++] = static_cast<char>(0xC0 | (cp >> 6));
+                out[n++] = static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                out[n++] = static_cast<char>(0xE0 | (cp >> 12));
+                out[n++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out[n++] = static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                out[n++] = static_cast<char>(0xF0 | (cp >> 18));
+                out[n++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out[n++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out[n++] = static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            break;
+        }
+        default:
+            throw std::runtime_error("Bad escape");
+        }
+    }
+    return n;
+}
+
+inline double parseNumber(std::string_view str) {
+    double d = 0;
+    auto res = std::from_chars(str.data(), str.data() + str.size(), d);
+    if (res.ec != std::errc() || res.ptr != str.data() + str.size())
+        throw std::runtime_error("Invalid number: " + std::string(str));
+    return d;
+}
+
 class Parser {
+    // Guards the recursion against hostile input
+    static constexpr int MAX_DEPTH = 64;
+
     Scanner scanner;
     Token currentToken;
+    Arena *arena = nullptr;
+    int depth = 0;
 
 public:
-    Parser(std::string_view json) : scanner(json) {
+    Parser(std::string_view json, Arena *arena = nullptr) : scanner(json), arena(arena) {
         currentToken = scanner.next(); // Prime the pump
     }
 
+    // Builds an owning Value tree
     static Value parse(std::string_view json) {
         Parser p(json);
         return p.parseValue();
     }
 
+    // Builds a Node tree in `arena` without copying strings out of `json`, unless they
+    // need unescaping. Throws std::runtime_error on malformed input.
+    static const Node *parse(std::string_view json, Arena &arena) {
+        Parser p(json, &arena);
+        Node *root = p.parseNode();
+        if (p.currentToken.type != TokenType::EndOfFile)
+            throw std::runtime_error("Trailing data after JSON value");
+        return root;
+    }
+
 private:
     void advance() { currentToken = scanner.next(); }
 
@@ -232,6 +484,28 @@ private:
         advance();
     }
 
+    void enter() {
+        if (++depth > MAX_DEPTH)
+            throw std::runtime_error("JSON nested too deeply");
+    }
+
+    std::string stringValue(const Token &token) {
+        std::string_view raw = token.value.substr(1, token.value.size() - 2);
+        if (!token.has_escapes)
+            return std::string(raw);
+        std::string out(raw.size(), '\0');
+        out.resize(unescape(raw, out.data()));
+        return out;
+    }
+
+    std::string_view stringView(const Token &token) {
+        std::string_view raw = token.value.substr(1, token.value.size() - 2);
+        if (!token.has_escapes)
+            return raw;
+        char *buf = static_cast<char *>(arena->allocate(raw.size() + 1, 1));
+        return std::string_view(buf, unescape(raw, buf));
+    }
+
     Value parseValue() {
         switch (currentToken.type) {
         case TokenType::Null:
@@ -244,14 +518,14 @@ private:
             advance();
             return Value(false);
         case TokenType::Number: {
-            std::string numStr(currentToken.value);
+            double d = parseNumber(currentToken.value);
             advance();
-            return std::stod(numStr);
+            return d;
         }
         case TokenType::String: {
-            std::string raw = std::string(currentToken.value);
+            std::string str = stringValue(currentToken);
             advance();
-            return raw.substr(1, raw.size() - 2);
+            return str;
         }
         case TokenType::LBracket:
             return parseArray();
@@ -263,11 +537,13 @@ private:
     }
 
     Value parseArray() {
+        enter();
         Array arr;
         advance();
 
         if (currentToken.type == TokenType::RBracket) {
             advance();
+            depth--;
             return arr;
         }
 
@@ -280,15 +556,18 @@ private:
             }
             expect(TokenType::Comma);
         }
+        depth--;
         return arr;
     }
 
     Value parseObject() {
+        enter();
         Object obj;
         advance();
 
         if (currentToken.type == TokenType::RBrace) {
             advance();
+            depth--;
             return obj;
         }
 
@@ -296,8 +575,7 @@ private:
             if (currentToken.type != TokenType::String)
                 throw std::runtime_error("Key must be string");
 
-            std::string keyRaw = std::string(currentToken.value);
-            std::string key = keyRaw.substr(1, keyRaw.size() - 2);
+            std::string key = stringValue(currentToken);
             advance();
 
             expect(TokenType::Colon);
@@ -310,8 +588,81 @@ private:
             }
             expect(TokenType::Comma);
         }
+        depth--;
         return obj;
     }
+
+    Node *parseNode() {
+        Node *node = arena->make<Node>();
+        switch (currentToken.type) {
+        case TokenType::Null:
+            advance();
+            return node;
+        case TokenType::True:
+        case TokenType::False:
+            node->type = Type::Bool;
+            node->boolean = currentToken.type == TokenType::True;
+            advance();
+            return node;
+        case TokenType::Number:
+            node->type = Type::Number;
+            node->number = parseNumber(currentToken.value);
+            advance();
+            return node;
+        case TokenType::String:
+            node->type = Type::String;
+            node->string = stringView(currentToken);
+            advance();
+            return node;
+        case TokenType::LBracket:
+        case TokenType::LBrace:
+            parseNodeContainer(node);
+            return node;
+        default:
+            throw std::runtime_error("Invalid Value Token");
+        }
+    }
+
+    // Arrays and objects share the same sibling-linked layout; objects also carry keys
+    void parseNodeContainer(Node *node) {
+        bool is_object = currentToken.type == TokenType::LBrace;
+        TokenType close = is_object ? TokenType::RBrace : TokenType::RBracket;
+        node->type = is_object ? Type::Object : Type::Array;
+
+        enter();
+        advance();
+
+        Node **tail = &node->first;
+        if (currentToken.type == close) {
+            advance();
+            depth--;
+            return;
+        }
+
+        while (true) {
+            std::string_view key;
+            if (is_object) {
+                if (currentToken.type != TokenType::String)
+                    throw std::runtime_error("Key must be string");
+                key = stringView(currentToken);
+                advance();
+                expect(TokenType::Colon);
+            }
+
+            Node *child = parseNode();
+            child->key = key;
+            *tail = child;
+            tail = &child->next;
+            node->size++;
+
+            if (currentToken.type == close) {
+                advance();
+                break;
+            }
+            expect(TokenType::Comma);
+        }
+        depth--;
+    }
 };
 
 } // namespace Json
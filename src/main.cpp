@@ -1,24 +1,36 @@
 #include "BluezClient/BluezClient.h"
+#include "Config/Config.h"
+#include "Log/Log.h"
+#include <cstdlib>
 #include <csignal>
-#include <cstdio>
 #include <cstring>
 #include <iostream>
 
 int main(int argc, char **argv) {
-    setbuf(stdout, NULL);
-
+    // Handled through a signalfd in BluezClient; blocked before any thread starts
     sigset_t set;
     sigemptyset(&set);
     sigaddset(&set, SIGUSR1);
+    sigaddset(&set, SIGUSR2);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGINT);
     pthread_sigmask(SIG_BLOCK, &set, nullptr);
 
+    // A closed stdout or stderr shows up as EPIPE from write(2), handled by the writers
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Log::init(Log::parse_level(std::getenv(Config::LOG_LEVEL_ENV), Log::Level::Info));
+    Log::install_crash_handler();
+
     try {
         BluezClient app;
         app.run();
     } catch (const std::exception &e) {
+        Log::shutdown();
         std::cerr << "Fatal Error: " << e.what() << std::endl;
         return 1;
     }
 
+    Log::shutdown();
     return 0;
 }
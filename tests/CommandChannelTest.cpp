@@ -0,0 +1,35 @@
+#include "Control/CommandChannel.h"
+#include "Test.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+TEST(command_channel_reads_pipe) {
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+
+    std::string seen;
+    CommandChannel channel(fds[0], [&seen](const Command &cmd) { seen = cmd.mac; });
+    CHECK(channel.is_open());
+
+    const char line[] = "{\"cmd\": \"select\", \"mac\": \"AA:BB:CC:DD:EE:FF\"}\n";
+    CHECK(write(fds[1], line, sizeof(line) - 1) == static_cast<ssize_t>(sizeof(line) - 1));
+    channel.on_readable();
+    CHECK_EQ(seen, std::string("AA:BB:CC:DD:EE:FF"));
+
+    close(fds[1]);
+    channel.on_readable();
+    CHECK(!channel.is_open());
+    close(fds[0]);
+}
+
+TEST(command_channel_ignores_terminal) {
+    // Reading a terminal from a background process group would stop us with SIGTTIN
+    int pty = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty < 0)
+        return; // No ptys in this environment
+    CommandChannel channel(pty, [](const Command &) {});
+    CHECK(!channel.is_open());
+    close(pty);
+}
@@ -0,0 +1,132 @@
+#include "Config/Config.h"
+#include "Decoder/Decoder.h"
+#include "Decoder/DecoderRegistry.h"
+#include "Test.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+static bool operator==(const BatteryData &a, const BatteryData &b) {
+    return a.left == b.left && a.right == b.right && a.case_val == b.case_val &&
+           a.charging == b.charging && a.in_pairing_mode == b.in_pairing_mode &&
+           a.vendor == b.vendor;
+}
+
+static std::ostream &operator<<(std::ostream &os, const BatteryData &d) {
+    return os << "{L:" << d.left << " R:" << d.right << " C:" << d.case_val
+              << " charging:" << d.charging << " pairing:" << d.in_pairing_mode << " "
+              << Decoder::vendor_name(d.vendor) << "}";
+}
+
+// AirPods Pro status message: L 90%, R 80%, case 70% and charging
+static const std::vector<std::uint8_t> AIRPODS = {
+    0x07, 0x19, 0x01, 0x0E, 0x20, 0x55, 0x98, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// Lid open in pairing mode, no battery information
+static const std::vector<std::uint8_t> AIRPODS_PAIRING = {
+    0x07, 0x19, 0x07, 0x0E, 0x20, 0x55, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static BatteryData battery(int left, int right, int case_val, bool charging, bool pairing,
+                           Vendor vendor) {
+    BatteryData d;
+    d.left = left;
+    d.right = right;
+    d.case_val = case_val;
+    d.charging = charging;
+    d.in_pairing_mode = pairing;
+    d.vendor = vendor;
+    return d;
+}
+
+TEST(decoder_airpods_status) {
+    BatteryData expected = battery(90, 80, 70, true, false, Vendor::Apple);
+
+    auto direct = Decoder::parse(AIRPODS);
+    CHECK(direct);
+    if (direct)
+        CHECK_EQ(*direct, expected);
+
+    auto routed = DecoderRegistry::decode(Config::APPLE_CID, AIRPODS);
+    CHECK(routed);
+    if (routed)
+        CHECK_EQ(*routed, expected);
+}
+
+TEST(decoder_airpods_pairing) {
+    auto r = DecoderRegistry::decode(Config::APPLE_CID, AIRPODS_PAIRING);
+    CHECK(r);
+    if (r)
+        CHECK_EQ(*r, battery(-1, -1, -1, false, true, Vendor::Apple));
+}
+
+TEST(decoder_rejects_invalid) {
+    // Not a status message (nearby info header)
+    std::vector<std::uint8_t> other = AIRPODS;
+    other[0] = 0x10;
+    CHECK(!Decoder::parse(other));
+    CHECK(!DecoderRegistry::decode(Config::APPLE_CID, other));
+
+    // Truncated before the battery bytes
+    std::vector<std::uint8_t> truncated(AIRPODS.begin(), AIRPODS.begin() + 7);
+    CHECK(!Decoder::parse(truncated));
+    CHECK(!DecoderRegistry::decode(Config::APPLE_CID, truncated));
+
+    // Status message without a single valid level and not in pairing mode
+    std::vector<std::uint8_t> empty = AIRPODS;
+    empty[6] = 0xFF;
+    empty[7] = 0x0F;
+    CHECK(!Decoder::parse(empty));
+    CHECK(!DecoderRegistry::decode(Config::APPLE_CID, empty));
+
+    CHECK(!DecoderRegistry::decode(Config::APPLE_CID, {}));
+}
+
+TEST(decoder_beats_models) {
+    const std::uint16_t models[] = {0x0320, 0x0520, 0x0620, 0x0920, 0x0B20,
+                                    0x0C20, 0x1020, 0x1120, 0x1220, 0x1620};
+    for (std::uint16_t model : models) {
+        std::vector<std::uint8_t> data = AIRPODS;
+        data[3] = static_cast<std::uint8_t>(model >> 8);
+        data[4] = static_cast<std::uint8_t>(model & 0xFF);
+
+        CHECK(Decoder::is_beats_packet(data));
+        auto r = DecoderRegistry::decode(Config::APPLE_CID, data);
+        CHECK(r);
+        if (r)
+            CHECK_EQ(*r, battery(90, 80, 70, true, false, Vendor::Beats));
+    }
+
+    // AirPods Pro model ID
+    CHECK(!Decoder::is_beats_packet(AIRPODS));
+}
+
+TEST(decoder_mixed_cid_dict) {
+    // One advert carrying several vendors' manufacturer data, all with bytes that would
+    // decode if they were routed to the Apple decoders
+    const std::map<std::uint16_t, std::vector<std::uint8_t>> dict = {
+        {0x0006, AIRPODS}, // Microsoft
+        {Config::APPLE_CID, AIRPODS},
+        {0x0075, AIRPODS}, // Samsung
+        {0x00E0, AIRPODS}, // Google
+    };
+
+    int decoded = 0;
+    for (const auto &[cid, data] : dict) {
+        bool handled = DecoderRegistry::handles(cid);
+        CHECK_EQ(handled, cid == Config::APPLE_CID);
+
+        auto r = DecoderRegistry::decode(cid, data);
+        if (cid != Config::APPLE_CID) {
+            CHECK(!r);
+            continue;
+        }
+        CHECK(r);
+        if (r) {
+            CHECK_EQ(*r, battery(90, 80, 70, true, false, Vendor::Apple));
+            decoded++;
+        }
+    }
+    CHECK_EQ(decoded, 1);
+}
@@ -0,0 +1,63 @@
+#include "Test.h"
+#include "Utils/json.hpp"
+#include <string>
+
+// A string ending in an escaped backslash: the closing quote right after "\\" ends the
+// string, it is not escaped itself
+static constexpr std::string_view TRAILING_BACKSLASH = R"({"path": "C:\\", "cmd": "pair"})";
+
+TEST(json_escaped_backslash_before_quote) {
+    Json::Value v = Json::Parser::parse(TRAILING_BACKSLASH);
+    CHECK(v.is_object());
+    CHECK_EQ(v["path"].dump(), std::string(R"("C:\\")"));
+    CHECK_EQ(v["cmd"].dump(), std::string(R"("pair")"));
+}
+
+TEST(json_escaped_backslash_before_quote_arena) {
+    Json::Arena arena;
+    const Json::Node *root = Json::Parser::parse(TRAILING_BACKSLASH, arena);
+    CHECK_EQ(root->size, size_t(2));
+    CHECK_EQ(root->get_string("path"), std::string_view("C:\\"));
+    CHECK_EQ(root->get_string("cmd"), std::string_view("pair"));
+}
+
+TEST(json_escapes_decode) {
+    Json::Arena arena;
+    const Json::Node *root =
+        Json::Parser::parse(R"({"s": "a\"b\/c\n\t\u0041", "plain": "x"})", arena);
+    CHECK_EQ(root->get_string("s"), std::string_view("a\"b/c\n\tA"));
+    CHECK_EQ(root->get_string("plain"), std::string_view("x"));
+}
+
+TEST(json_oversize_string_gets_own_block) {
+    // Escaped, so the decoded copy has to come from the arena, and bigger than a block
+    std::string name(3000, 'n');
+    name[0] = '\\';
+    name[1] = 't';
+    std::string json = R"({"cmd": "pair", "name": ")" + name + R"("})";
+
+    Json::Arena arena(256);
+    for (int round = 0; round < 2; round++) {
+        const Json::Node *root = Json::Parser::parse(json, arena);
+        std::string_view decoded = root->get_string("name");
+        CHECK_EQ(decoded.size(), size_t(2999));
+        CHECK(decoded.front() == '\t');
+        CHECK_EQ(decoded.find_first_not_of('n', 1), std::string_view::npos);
+        CHECK_EQ(root->get_string("cmd"), std::string_view("pair"));
+        arena.reset();
+    }
+}
+
+TEST(json_integral_numbers_dump_without_fraction) {
+    Json::Value j;
+    j["iterations"] = 16777216.0;
+    j["samples"] = 10;
+    j["negative"] = -3;
+    j["median"] = 152.5;
+    CHECK_EQ(j.dump(), std::string(R"({"iterations": 16777216, "median": 152.500000, )"
+                                   R"("negative": -3, "samples": 10})"));
+
+    // Past 2^53 a double can't tell neighbouring integers apart, so it keeps the fraction
+    Json::Value big(1e300);
+    CHECK(big.dump().find('.') != std::string::npos);
+}
@@ -0,0 +1,225 @@
+#include "Log/Log.h"
+#include "Test.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// The logger is process-wide state, so every case runs in a child of its own.
+// Returns what the child wrote to stderr; `status` gets its waitpid() status.
+template <typename Fn> static std::string run_in_child(Fn fn, int &status) {
+    int fds[2];
+    if (pipe(fds) < 0)
+        return {};
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        dup2(fds[1], STDERR_FILENO);
+        alarm(5); // A hang fails the case instead of the whole run
+        _exit(fn());
+    }
+
+    close(fds[1]);
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+        out.append(buf, static_cast<size_t>(n));
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    return out;
+}
+
+TEST(log_crash_dump_includes_queued_records) {
+    int status = 0;
+    std::string out = run_in_child(
+        [] {
+            // No drain thread: both records are still in the ring when we crash
+            Log::install_crash_handler();
+            LOG_INFO("Adapter powered:", "/org/bluez/hci0", 1);
+            LOG_WARN("No Bluetooth Adapter found");
+            std::raise(SIGSEGV);
+            return 0;
+        },
+        status);
+
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+    size_t first = out.find("INFO: Adapter powered: /org/bluez/hci0 (1)\n");
+    size_t second = out.find("WARN: No Bluetooth Adapter found\n");
+    CHECK(first != std::string::npos);
+    CHECK(second != std::string::npos);
+    CHECK(first < second);
+}
+
+TEST(log_crash_dump_history_before_queue) {
+    int status = 0;
+    std::string out = run_in_child(
+        [] {
+            Log::init(Log::Level::Info);
+            Log::install_crash_handler();
+            LOG_INFO("formatted");
+            Log::shutdown(); // Drains "formatted" into the history
+            LOG_ERROR("queued", {}, -42);
+            std::raise(SIGABRT);
+            return 0;
+        },
+        status);
+
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    size_t header = out.find("hyprpods crashed");
+    CHECK(header != std::string::npos);
+    size_t formatted = out.find("INFO: formatted\n", header);
+    size_t queued = out.find("ERROR: queued (-42)\n", header);
+    CHECK(formatted != std::string::npos);
+    CHECK(queued != std::string::npos);
+    CHECK(formatted < queued);
+}
+
+TEST(log_dump_recent_does_not_block_caller) {
+    int status = 0;
+    run_in_child(
+        [] {
+            Log::init(Log::Level::Info);
+            LOG_INFO("before dump");
+
+            // A dump target that can't take a single byte right now
+            int fds[2];
+            if (pipe(fds) < 0)
+                return 2;
+            fcntl(fds[1], F_SETFL, O_NONBLOCK);
+            char fill[4096] = {};
+            while (write(fds[1], fill, sizeof(fill)) > 0) {
+            }
+            fcntl(fds[1], F_SETFL, 0);
+
+            Log::dump_recent(fds[1]); // Must return although the pipe is full
+
+            // Unblock the drain thread and look for the record in what it wrote
+            fcntl(fds[0], F_SETFL, O_NONBLOCK);
+            std::string out;
+            char buf[4096];
+            for (int i = 0; i < 200 && out.find("INFO: before dump") == std::string::npos;
+                 i++) {
+                ssize_t n = read(fds[0], buf, sizeof(buf));
+                if (n > 0)
+                    out.append(buf, static_cast<size_t>(n));
+                else
+                    poll(nullptr, 0, 10);
+            }
+            Log::shutdown();
+            return out.find("INFO: before dump") != std::string::npos ? 0 : 1;
+        },
+        status);
+
+    CHECK(WIFEXITED(status));
+    CHECK_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(log_write_line_does_not_block_caller) {
+    int status = 0;
+    run_in_child(
+        [] {
+            Log::init(Log::Level::Info);
+
+            // stderr becomes a pipe that can't take a single byte right now
+            int fds[2];
+            if (pipe(fds) < 0)
+                return 2;
+            fcntl(fds[1], F_SETFL, O_NONBLOCK);
+            char fill[4096] = {};
+            while (write(fds[1], fill, sizeof(fill)) > 0) {
+            }
+            fcntl(fds[1], F_SETFL, 0);
+            dup2(fds[1], STDERR_FILENO);
+
+            Log::write_line("{\"idle\": true}\n"); // Must return although stderr is full
+
+            fcntl(fds[0], F_SETFL, O_NONBLOCK);
+            std::string out;
+            char buf[4096];
+            for (int i = 0; i < 200 && out.find("{\"idle\": true}\n") == std::string::npos;
+                 i++) {
+                ssize_t n = read(fds[0], buf, sizeof(buf));
+                if (n > 0)
+                    out.append(buf, static_cast<size_t>(n));
+                else
+                    poll(nullptr, 0, 10);
+            }
+            Log::shutdown();
+            return out.find("{\"idle\": true}\n") != std::string::npos ? 0 : 1;
+        },
+        status);
+
+    CHECK(WIFEXITED(status));
+    CHECK_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(log_concurrent_producers_lose_no_wakeup) {
+    int status = 0;
+    run_in_child(
+        [] {
+            Log::init(Log::Level::Info);
+            int fds[2];
+            if (pipe(fds) < 0)
+                return 2;
+            dup2(fds[1], STDERR_FILENO);
+            fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+            constexpr int THREADS = 4;
+            constexpr int RECORDS = 2000;
+            std::string out;
+            char buf[65536];
+            auto read_some = [&out, &buf, fd = fds[0]] {
+                ssize_t n;
+                while ((n = read(fd, buf, sizeof(buf))) > 0)
+                    out.append(buf, static_cast<size_t>(n));
+            };
+
+            std::atomic<int> finished{0};
+            std::vector<std::thread> producers;
+            for (int t = 0; t < THREADS; t++) {
+                producers.emplace_back([&finished] {
+                    // In short bursts, so the drain thread keeps going back to sleep
+                    for (int i = 0; i < RECORDS; i++) {
+                        LOG_INFO("stress", {}, i);
+                        if (i % 8 == 0)
+                            std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    }
+                    finished++;
+                });
+            }
+            while (finished < THREADS) {
+                read_some();
+                poll(nullptr, 0, 1);
+            }
+            for (auto &p : producers)
+                p.join();
+
+            // Records that found the ring full are counted as dropped. All others must come
+            // out without any further logging.
+            auto written = [&out] {
+                size_t count = 0;
+                for (size_t pos = 0; (pos = out.find("INFO: stress", pos)) != std::string::npos;
+                     pos++)
+                    count++;
+                return count;
+            };
+            const size_t total = THREADS * RECORDS;
+            for (int i = 0; i < 200 && written() + Log::dropped() < total; i++) {
+                read_some();
+                poll(nullptr, 0, 10);
+            }
+            return written() + Log::dropped() == total ? 0 : 1;
+        },
+        status);
+
+    CHECK(WIFEXITED(status));
+    CHECK_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,28 @@
+#include "Output/StdoutWriter.h"
+#include "Test.h"
+#include <csignal>
+#include <string>
+#include <unistd.h>
+
+TEST(stdout_writer_closes_when_reader_goes) {
+    // As in main(): a vanished reader must show up as EPIPE, not kill us
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    StdoutWriter writer(fds[1]);
+
+    writer.write_line("{\"text\": \"\"}");
+    CHECK_EQ(writer.lines_written(), std::uint64_t(1));
+    CHECK(!writer.is_closed());
+
+    close(fds[0]);
+    writer.write_line("{\"text\": \"L:90%\"}");
+    CHECK(writer.is_closed());
+    CHECK(!writer.has_pending());
+    CHECK_EQ(writer.lines_dropped(), std::uint64_t(1));
+
+    writer.write_line("{\"text\": \"L:80%\"}"); // Dropped without trying to write
+    CHECK_EQ(writer.lines_dropped(), std::uint64_t(2));
+    close(fds[1]);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal unit test registry for hyprpods_tests.
+// TEST(name) { ... } defines and registers a case; CHECK/CHECK_EQ record failures and
+// let the case carry on, so one run reports every broken expectation.
+namespace Test {
+struct Case {
+    const char *name;
+    void (*fn)();
+};
+
+inline std::vector<Case> &cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int &failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Register {
+    Register(const char *name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+inline void fail(const char *file, int line, const std::string &what) {
+    std::cerr << file << ":" << line << ": " << what << "\n";
+    failures()++;
+}
+
+template <typename A, typename B>
+void check_eq(const A &a, const B &b, const char *expr, const char *file, int line) {
+    if (a == b)
+        return;
+    std::ostringstream msg;
+    msg << "CHECK_EQ(" << expr << ") failed: " << a << " != " << b;
+    fail(file, line, msg.str());
+}
+} // namespace Test
+
+#define TEST(name)                                                                                 \
+    static void name();                                                                            \
+    static Test::Register name##_register(#name, name);                                            \
+    static void name()
+
+#define CHECK(cond)                                                                                \
+    do {                                                                                           \
+        if (!(cond))                                                                               \
+            Test::fail(__FILE__, __LINE__, "CHECK(" #cond ") failed");                             \
+    } while (0)
+
+#define CHECK_EQ(a, b) Test::check_eq((a), (b), #a ", " #b, __FILE__, __LINE__)
@@ -0,0 +1,212 @@
+"""Runs hyprpods against mock BlueZ/logind services on a private dbus-daemon.
+
+Usage from a test script:
+
+    with Harness(sys.argv[1]) as h:
+        h.mock.AddAdapter("hci0", "00:11:22:33:44:55", True)
+        h.start()
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+
+Exits with SKIP (77) when dbus-daemon or the Python D-Bus bindings are missing.
+"""
+
+import json
+import os
+import queue
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+SKIP = 77
+
+try:
+    import dbus
+    import gi  # noqa: F401, needed by mock_services.py
+except ImportError as e:
+    print(f"SKIP: {e}")
+    sys.exit(SKIP)
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+BUS_CONFIG = """<!DOCTYPE busconfig PUBLIC "-//freedesktop//DTD D-BUS Bus Configuration 1.0//EN"
+ "http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd">
+<busconfig>
+  <type>system</type>
+  <listen>unix:path={socket}</listen>
+  <auth>EXTERNAL</auth>
+  <policy context="default">
+    <allow user="*"/>
+    <allow own="*"/>
+    <allow send_type="method_call"/>
+    <allow send_type="signal"/>
+    <allow send_type="method_return"/>
+    <allow send_type="error"/>
+    <allow receive_type="method_call"/>
+    <allow receive_type="signal"/>
+    <allow receive_type="method_return"/>
+    <allow receive_type="error"/>
+  </policy>
+</busconfig>
+"""
+
+# AirPods Pro status message: L 90%, R 80%, case 70% and charging
+AIRPODS_PAYLOAD = [0x07, 0x19, 0x01, 0x0E, 0x20, 0x55, 0x98, 0x47,
+                   0x00, 0x00, 0x00, 0x00, 0x00, 0x00]
+APPLE_CID = 0x004C
+
+
+class TestFailure(Exception):
+    pass
+
+
+def check(condition, message):
+    if not condition:
+        raise TestFailure(message)
+
+
+def wait_for(predicate, timeout, interval=0.01):
+    """Polls `predicate` until it returns something truthy or `timeout` seconds pass."""
+    deadline = time.monotonic() + timeout
+    while True:
+        result = predicate()
+        if result or time.monotonic() >= deadline:
+            return result
+        time.sleep(interval)
+
+
+class Stream:
+    """Collects (monotonic time, line) pairs from a pipe on a background thread."""
+
+    def __init__(self, pipe, echo_prefix=None):
+        self.lines = []
+        self.lock = threading.Lock()
+        self.echo_prefix = echo_prefix
+        self.thread = threading.Thread(target=self._read, args=(pipe,), daemon=True)
+        self.thread.start()
+
+    def _read(self, pipe):
+        for raw in iter(pipe.readline, b""):
+            line = raw.decode(errors="replace").rstrip("\n")
+            with self.lock:
+                self.lines.append((time.monotonic(), line))
+            if self.echo_prefix:
+                print(self.echo_prefix + line, file=sys.stderr)
+
+    def snapshot(self):
+        with self.lock:
+            return list(self.lines)
+
+    def wait(self, predicate, timeout, since=0.0):
+        """First (time, line) after `since` for which predicate(line) holds, or None."""
+        def find():
+            for t, line in self.snapshot():
+                if t >= since and predicate(line):
+                    return (t, line)
+            return None
+        return wait_for(find, timeout)
+
+
+class Harness:
+    def __init__(self, binary, env=None):
+        self.binary = os.path.abspath(binary)
+        self.env = env or {}
+        self.tmp = None
+        self.daemon = None
+        self.mock_proc = None
+        self.proc = None
+
+    def __enter__(self):
+        if not shutil.which("dbus-daemon"):
+            print("SKIP: dbus-daemon not found")
+            sys.exit(SKIP)
+
+        self.tmp = tempfile.mkdtemp(prefix="hyprpods-bus-")
+        socket = os.path.join(self.tmp, "system_bus_socket")
+        config = os.path.join(self.tmp, "bus.conf")
+        with open(config, "w") as f:
+            f.write(BUS_CONFIG.format(socket=socket))
+
+        self.daemon = subprocess.Popen(
+            ["dbus-daemon", "--config-file=" + config, "--nofork", "--print-address"],
+            stdout=subprocess.PIPE)
+        self.address = self.daemon.stdout.readline().decode().strip()
+        os.environ["DBUS_SYSTEM_BUS_ADDRESS"] = self.address
+
+        self.mock_proc = subprocess.Popen(
+            [sys.executable, os.path.join(HERE, "mock_services.py")], stdout=subprocess.PIPE)
+        if self.mock_proc.stdout.readline().strip() != b"READY":
+            raise TestFailure("mock services did not start")
+
+        self.bus = dbus.bus.BusConnection(self.address)
+        self.mock = dbus.Interface(
+            self.bus.get_object("org.hyprpods.Mock", "/org/hyprpods/Mock"),
+            "org.hyprpods.Mock")
+        return self
+
+    def __exit__(self, *exc):
+        if self.proc and self.proc.poll() is None:
+            self.proc.kill()
+            self.proc.wait()
+        if self.mock_proc:
+            self.mock_proc.kill()
+            self.mock_proc.wait()
+        if self.daemon:
+            self.daemon.kill()
+            self.daemon.wait()
+        shutil.rmtree(self.tmp, ignore_errors=True)
+        return False
+
+    def start(self, log_level="info", stdout=subprocess.PIPE):
+        """`stdout` may be an fd for the test to manage; then self.stdout isn't collected."""
+        env = dict(os.environ, HYPRPODS_LOG=log_level, **self.env)
+        self.started = time.monotonic()
+        self.proc = subprocess.Popen([self.binary], stdin=subprocess.PIPE,
+                                     stdout=stdout, stderr=subprocess.PIPE, env=env)
+        self.stdout = Stream(self.proc.stdout) if stdout == subprocess.PIPE else None
+        self.stderr = Stream(self.proc.stderr, echo_prefix="hyprpods: ")
+
+    def stop(self, timeout=5):
+        """SIGTERM and wait; returns the exit status."""
+        self.proc.send_signal(signal.SIGTERM)
+        return self.proc.wait(timeout)
+
+    def send(self, command):
+        self.proc.stdin.write((json.dumps(command) + "\n").encode())
+        self.proc.stdin.flush()
+
+    def calls(self, path=None, method=None, since=0.0):
+        return [(t, p, m, d) for t, p, m, d in self.mock.Calls()
+                if t >= since and (path is None or p == path) and
+                (method is None or m == method)]
+
+    def wait_call(self, path, method, timeout=2.0, since=0.0):
+        """Time of the first matching call after `since`; fails the test if none comes."""
+        found = wait_for(lambda: self.calls(path, method, since), timeout)
+        check(found, f"{method} on {path} not called within {timeout}s")
+        return found[0][0]
+
+    def stats(self, timeout=2.0):
+        """Sends dump-stats and returns the parsed reply."""
+        since = time.monotonic()
+        self.send({"cmd": "dump-stats"})
+        line = self.stderr.wait(lambda l: l.startswith("{"), timeout, since)
+        check(line, "no dump-stats reply")
+        return json.loads(line[1])
+
+
+def run(test):
+    """Runs test(binary) and turns the outcome into an exit status for ctest."""
+    if len(sys.argv) != 2:
+        print(f"usage: {sys.argv[0]} <path to hyprpods>")
+        return 2
+    try:
+        test(sys.argv[1])
+    except TestFailure as e:
+        print(f"FAIL: {e}")
+        return 1
+    print("PASS")
+    return 0
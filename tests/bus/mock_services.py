@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""Mock org.bluez and org.freedesktop.login1 for the hyprpods bus tests.
+
+Runs on the bus given by DBUS_SYSTEM_BUS_ADDRESS and also owns org.hyprpods.Mock,
+a control interface the tests use to add adapters and devices, flip power, send
+adverts and suspend. Every method hyprpods calls is recorded with a CLOCK_MONOTONIC
+timestamp and can be read back through Calls().
+
+Adverts follow BlueZ's discovery rules: nothing is reported by an adapter that is
+not discovering, and with DuplicateData=false a device is only reported again when
+its manufacturer data changes.
+"""
+
+import os
+import select
+import sys
+import time
+
+import dbus
+import dbus.mainloop.glib
+import dbus.service
+from gi.repository import GLib
+
+BLUEZ = "org.bluez"
+LOGIN = "org.freedesktop.login1"
+CONTROL = "org.hyprpods.Mock"
+
+ADAPTER_IFACE = "org.bluez.Adapter1"
+DEVICE_IFACE = "org.bluez.Device1"
+PROPS_IFACE = "org.freedesktop.DBus.Properties"
+MGR_IFACE = "org.freedesktop.DBus.ObjectManager"
+LOGIN_MGR_IFACE = "org.freedesktop.login1.Manager"
+
+calls = []
+
+
+def record(path, method, detail=""):
+    calls.append((time.monotonic(), path, method, detail))
+
+
+class PropertyObject(dbus.service.Object):
+    def __init__(self, bus, path, iface, props):
+        super().__init__(bus, path)
+        self.path = path
+        self.iface = iface
+        self.props = props
+
+    def update(self, changes):
+        self.props.update(changes)
+        self.PropertiesChanged(self.iface, changes, [])
+
+    @dbus.service.method(PROPS_IFACE, in_signature="ss", out_signature="v")
+    def Get(self, iface, name):
+        return self.props[name]
+
+    @dbus.service.method(PROPS_IFACE, in_signature="s", out_signature="a{sv}")
+    def GetAll(self, iface):
+        return self.props if iface == self.iface else {}
+
+    @dbus.service.method(PROPS_IFACE, in_signature="ssv")
+    def Set(self, iface, name, value):
+        record(self.path, "Set", f"{name}={bool(value)}")
+        self.update({name: value})
+
+    @dbus.service.signal(PROPS_IFACE, signature="sa{sv}as")
+    def PropertiesChanged(self, iface, changed, invalidated):
+        pass
+
+
+class Adapter(PropertyObject):
+    def __init__(self, bus, path, address, powered):
+        super().__init__(bus, path, ADAPTER_IFACE, {
+            "Address": dbus.String(address),
+            "Powered": dbus.Boolean(powered),
+            "Discovering": dbus.Boolean(False),
+        })
+        self.duplicate_data = True
+
+    @property
+    def discovering(self):
+        return bool(self.props["Discovering"])
+
+    def set_powered(self, powered):
+        changes = {"Powered": dbus.Boolean(powered)}
+        if not powered and self.discovering:
+            # BlueZ ends every discovery session when the adapter goes down
+            changes["Discovering"] = dbus.Boolean(False)
+            self.duplicate_data = True
+        self.update(changes)
+
+    @dbus.service.method(ADAPTER_IFACE, in_signature="a{sv}")
+    def SetDiscoveryFilter(self, filter):
+        self.duplicate_data = bool(filter.get("DuplicateData", True))
+        record(self.path, "SetDiscoveryFilter", f"DuplicateData={self.duplicate_data}")
+
+    @dbus.service.method(ADAPTER_IFACE)
+    def StartDiscovery(self):
+        record(self.path, "StartDiscovery")
+        if not self.props["Powered"]:
+            raise dbus.DBusException("Resource Not Ready",
+                                     name="org.bluez.Error.NotReady")
+        self.update({"Discovering": dbus.Boolean(True)})
+
+    @dbus.service.method(ADAPTER_IFACE)
+    def StopDiscovery(self):
+        record(self.path, "StopDiscovery")
+        if self.discovering:
+            self.update({"Discovering": dbus.Boolean(False)})
+
+
+class Device(PropertyObject):
+    def __init__(self, bus, path, adapter, address):
+        super().__init__(bus, path, DEVICE_IFACE, {
+            "Address": dbus.String(address),
+            "Adapter": dbus.ObjectPath(adapter.path),
+            "Paired": dbus.Boolean(False),
+            "Connected": dbus.Boolean(False),
+        })
+        self.adapter = adapter
+        self.last_data = None
+
+    def advertise(self, cid, payload, rssi):
+        if not self.adapter.discovering:
+            return False
+        data = (int(cid), bytes(payload))
+        if not self.adapter.duplicate_data and data == self.last_data:
+            return False
+        self.last_data = data
+        mfg = dbus.Dictionary({dbus.UInt16(cid): dbus.Array(payload, signature="y")},
+                              signature="qv")
+        self.PropertiesChanged(DEVICE_IFACE, {
+            "ManufacturerData": mfg,
+            "RSSI": dbus.Int16(rssi),
+        }, [])
+        return True
+
+    @dbus.service.method(DEVICE_IFACE)
+    def Pair(self):
+        record(self.path, "Pair")
+        self.update({"Paired": dbus.Boolean(True)})
+
+    @dbus.service.method(DEVICE_IFACE)
+    def Connect(self):
+        record(self.path, "Connect")
+        self.update({"Connected": dbus.Boolean(True)})
+
+
+class Root(dbus.service.Object):
+    def __init__(self, bus, objects):
+        super().__init__(bus, "/")
+        self.objects = objects
+
+    @dbus.service.method(MGR_IFACE, out_signature="a{oa{sa{sv}}}")
+    def GetManagedObjects(self):
+        record("/", "GetManagedObjects")
+        return {path: {obj.iface: obj.props} for path, obj in self.objects.items()}
+
+    @dbus.service.signal(MGR_IFACE, signature="oa{sa{sv}}")
+    def InterfacesAdded(self, path, interfaces):
+        pass
+
+    @dbus.service.signal(MGR_IFACE, signature="oas")
+    def InterfacesRemoved(self, path, interfaces):
+        pass
+
+
+class Login(dbus.service.Object):
+    def __init__(self, bus):
+        super().__init__(bus, "/org/freedesktop/login1")
+        self.inhibitors = []  # Write ends; readable side goes to the caller
+
+    @dbus.service.method(LOGIN_MGR_IFACE, in_signature="ssss", out_signature="h")
+    def Inhibit(self, what, who, why, mode):
+        record("/org/freedesktop/login1", "Inhibit", f"{what}:{mode}")
+        read_end, write_end = os.pipe()
+        self.inhibitors.append(write_end)
+        fd = dbus.types.UnixFd(read_end)
+        os.close(read_end)
+        return fd
+
+    def held(self):
+        # An inhibitor is released once every copy of its read end is closed
+        held = []
+        for fd in self.inhibitors:
+            poller = select.poll()
+            poller.register(fd, select.POLLERR)
+            if poller.poll(0):
+                os.close(fd)
+            else:
+                held.append(fd)
+        self.inhibitors = held
+        return len(held)
+
+    @dbus.service.signal(LOGIN_MGR_IFACE, signature="b")
+    def PrepareForSleep(self, start):
+        pass
+
+
+class Control(dbus.service.Object):
+    def __init__(self, bus, loop):
+        super().__init__(bus, "/org/hyprpods/Mock")
+        self.bus = bus
+        self.loop = loop
+        self.objects = {}
+        self.root = Root(bus, self.objects)
+        self.login = Login(bus)
+        self.noise = None
+
+    def device_path(self, adapter, address):
+        return f"/org/bluez/{adapter}/dev_" + address.upper().replace(":", "_")
+
+    @dbus.service.method(CONTROL, in_signature="ssb")
+    def AddAdapter(self, name, address, powered):
+        path = f"/org/bluez/{name}"
+        self.objects[path] = Adapter(self.bus, path, address, powered)
+        self.root.InterfacesAdded(path, {ADAPTER_IFACE: self.objects[path].props})
+
+    @dbus.service.method(CONTROL, in_signature="s")
+    def RemoveAdapter(self, name):
+        path = f"/org/bluez/{name}"
+        for dev_path in [p for p in self.objects if p.startswith(path + "/")]:
+            self.objects.pop(dev_path).remove_from_connection()
+            self.root.InterfacesRemoved(dev_path, [DEVICE_IFACE])
+        self.objects.pop(path).remove_from_connection()
+        self.root.InterfacesRemoved(path, [ADAPTER_IFACE])
+
+    @dbus.service.method(CONTROL, in_signature="sb")
+    def SetPowered(self, name, powered):
+        self.objects[f"/org/bluez/{name}"].set_powered(powered)
+
+    @dbus.service.method(CONTROL, in_signature="ss")
+    def AddDevice(self, adapter, address):
+        path = self.device_path(adapter, address)
+        self.objects[path] = Device(self.bus, path, self.objects[f"/org/bluez/{adapter}"],
+                                    address)
+        self.root.InterfacesAdded(path, {DEVICE_IFACE: self.objects[path].props})
+
+    @dbus.service.method(CONTROL, in_signature="ssqayn", out_signature="b")
+    def Advertise(self, adapter, address, cid, payload, rssi):
+        return self.objects[self.device_path(adapter, address)].advertise(cid, payload, rssi)
+
+    @dbus.service.method(CONTROL, in_signature="ssqayd")
+    def StartNoise(self, adapter, address, cid, payload, hz):
+        # The same advert over and over, like a phone or beacon sitting nearby
+        device = self.objects[self.device_path(adapter, address)]
+        self.StopNoise()
+        self.noise = GLib.timeout_add(int(1000 / hz),
+                                      lambda: device.advertise(cid, payload, -70) or True)
+
+    @dbus.service.method(CONTROL)
+    def StopNoise(self):
+        if self.noise is not None:
+            GLib.source_remove(self.noise)
+            self.noise = None
+
+    @dbus.service.method(CONTROL, in_signature="b")
+    def PrepareForSleep(self, start):
+        self.login.PrepareForSleep(start)
+
+    @dbus.service.method(CONTROL, out_signature="i")
+    def InhibitorsHeld(self):
+        return self.login.held()
+
+    @dbus.service.method(CONTROL, out_signature="a(dsss)")
+    def Calls(self):
+        return calls
+
+    @dbus.service.method(CONTROL)
+    def Quit(self):
+        self.loop.quit()
+
+
+def main():
+    dbus.mainloop.glib.DBusGMainLoop(set_as_default=True)
+    bus = dbus.bus.BusConnection(os.environ["DBUS_SYSTEM_BUS_ADDRESS"])
+    loop = GLib.MainLoop()
+    names = [dbus.service.BusName(name, bus) for name in (BLUEZ, LOGIN, CONTROL)]
+    Control(bus, loop)
+    print("READY", flush=True)
+    loop.run()
+    del names
+
+
+if __name__ == "__main__":
+    sys.exit(main())
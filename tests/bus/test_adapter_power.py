@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""Discovery comes back quickly after the adapter is power-cycled or plugged in late."""
+
+import sys
+import time
+
+from harness import Harness, check, run
+
+# Upper bound on power-on (or hotplug) to StartDiscovery
+MAX_RECOVERY = 0.3
+
+
+def test(binary):
+    with Harness(binary) as h:
+        # Start with no adapter at all: hyprpods must not sit in a startup retry loop
+        h.start()
+        check(h.stderr.wait(lambda l: "waiting for one to appear" in l, 2.0),
+              "no warning about the missing adapter")
+
+        added = time.monotonic()
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        started = h.wait_call("/org/bluez/hci0", "StartDiscovery", timeout=2.0)
+        check(started - added <= MAX_RECOVERY,
+              f"hotplugged adapter took {started - added:.3f}s to scan")
+
+        for cycle in range(3):
+            h.mock.SetPowered("hci0", False)
+            check(h.stderr.wait(lambda l: "Adapter powered:" in l and "(0)" in l, 1.0,
+                                time.monotonic() - 0.5),
+                  "power off not noticed")
+
+            powered_on = time.monotonic()
+            h.mock.SetPowered("hci0", True)
+            started = h.wait_call("/org/bluez/hci0", "StartDiscovery", timeout=2.0,
+                                  since=powered_on)
+            check(started - powered_on <= MAX_RECOVERY,
+                  f"cycle {cycle}: discovery restarted after {started - powered_on:.3f}s")
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
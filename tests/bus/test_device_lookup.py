@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+"""Pairing finds a device known to several adapters, after one of them goes away."""
+
+import sys
+import time
+
+from harness import Harness, check, run
+
+ADDRESS = "AA:BB:CC:DD:EE:FF"
+DEV = "/dev_AA_BB_CC_DD_EE_FF"
+
+
+def test(binary):
+    with Harness(binary) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        h.mock.AddAdapter("hci1", "00:00:00:00:00:02", True)
+        h.mock.AddDevice("hci0", ADDRESS)
+        h.mock.AddDevice("hci1", ADDRESS)
+        h.start()
+        h.wait_call("/org/bluez/hci1", "StartDiscovery")
+
+        # Unplug the dongle: its copy of the device goes, the one on hci0 stays
+        since = time.monotonic()
+        h.mock.RemoveAdapter("hci1")
+        check(h.stderr.wait(lambda l: "Adapter removed:" in l, 2.0, since),
+              "adapter removal not noticed")
+
+        since = time.monotonic()
+        h.send({"cmd": "pair", "mac": ADDRESS.lower()})
+        h.wait_call("/org/bluez/hci0" + DEV, "Connect", since=since)
+
+        # With both present, the copy on the powered adapter is used
+        h.mock.AddAdapter("hci1", "00:00:00:00:00:02", True)
+        h.mock.AddDevice("hci1", ADDRESS)
+        h.wait_call("/org/bluez/hci1", "StartDiscovery", since=since)
+        h.mock.SetPowered("hci0", False)
+        check(h.stderr.wait(lambda l: "Adapter powered:" in l and "(0)" in l, 2.0, since),
+              "power off not noticed")
+
+        since = time.monotonic()
+        h.send({"cmd": "pair", "mac": ADDRESS})
+        h.wait_call("/org/bluez/hci1" + DEV, "Connect", since=since)
+        check(not h.calls("/org/bluez/hci0" + DEV, "Connect", since),
+              "pairing went to the device on the powered-off adapter")
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Once idle, background bus traffic costs hyprpods (almost) no wakeups or CPU time."""
+
+import glob
+import json
+import sys
+import threading
+import time
+
+import dbus
+import dbus.lowlevel
+
+from harness import AIRPODS_PAYLOAD, APPLE_CID, Harness, check, run
+
+ADDRESS = "AA:BB:CC:DD:EE:FF"
+PHONE = "11:22:33:44:55:66"  # A foreign device repeating the same advert
+
+NOISE_HZ = 50
+MEASURE_SECONDS = 3.0
+# Upper bounds over MEASURE_SECONDS, summed over all threads. Before idle the noise alone
+# is NOISE_HZ * MEASURE_SECONDS = 150 wakeups.
+MAX_SWITCHES = 10
+MAX_CPU_NS = 20_000_000
+
+
+def is_hidden(line):
+    try:
+        return json.loads(line).get("text") == ""
+    except ValueError:
+        return False
+
+
+def sched_totals(pid):
+    """(CPU time in ns, voluntary context switches) summed over the threads of `pid`."""
+    cpu_ns = switches = 0
+    for task in glob.glob(f"/proc/{pid}/task/*"):
+        try:
+            with open(task + "/schedstat") as f:
+                cpu_ns += int(f.read().split()[0])
+            with open(task + "/status") as f:
+                for line in f:
+                    if line.startswith("voluntary_ctxt_switches:"):
+                        switches += int(line.split()[1])
+        except FileNotFoundError:
+            pass  # Thread exited while we looked
+    return cpu_ns, switches
+
+
+def unrelated_signals(address, stop):
+    """PropertiesChanged that the match rule must keep away from hyprpods: the right path
+    from the wrong sender, and the wrong path."""
+    bus = dbus.bus.BusConnection(address)
+    targets = ["/org/bluez/hci0/dev_" + PHONE.replace(":", "_"), "/org/hyprpods/Other"]
+    while not stop.wait(1 / NOISE_HZ):
+        for path in targets:
+            msg = dbus.lowlevel.SignalMessage(path, "org.freedesktop.DBus.Properties",
+                                              "PropertiesChanged")
+            msg.append("org.bluez.Device1", {"RSSI": dbus.Int16(-70)}, [],
+                       signature="sa{sv}as")
+            bus.send_message(msg)
+
+
+def test(binary):
+    with Harness(binary, env={"HYPRPODS_IDLE_AFTER": "1"}) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        h.mock.AddDevice("hci0", ADDRESS)
+        h.mock.AddDevice("hci0", PHONE)
+        h.start()
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+
+        since = time.monotonic()
+        h.mock.Advertise("hci0", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -60)
+        check(h.stdout.wait(lambda l: "L:90%" in l, 2.0, since), "widget not shown")
+
+        h.mock.StartNoise("hci0", PHONE, 0x0006, [0x01, 0x09, 0x20, 0x02], NOISE_HZ)
+        stop = threading.Event()
+        sender = threading.Thread(target=unrelated_signals, args=(h.address, stop),
+                                  daemon=True)
+        sender.start()
+        try:
+            check(h.stderr.wait(lambda l: "entering idle mode" in l, 5.0, since),
+                  "never went idle")
+            check(any(d == "DuplicateData=False" for _, _, _, d in
+                      h.calls("/org/bluez/hci0", "SetDiscoveryFilter", since)),
+                  "idle did not turn off duplicate reporting")
+            check(h.stdout.wait(is_hidden, 5.0, since), "stale widget not hidden")
+
+            # Let anything triggered by hiding the widget settle before measuring
+            time.sleep(0.2)
+            cpu_before, switches_before = sched_totals(h.proc.pid)
+            time.sleep(MEASURE_SECONDS)
+            cpu_after, switches_after = sched_totals(h.proc.pid)
+        finally:
+            stop.set()
+            sender.join()
+            h.mock.StopNoise()
+
+        switches = switches_after - switches_before
+        cpu_ns = cpu_after - cpu_before
+        print(f"idle for {MEASURE_SECONDS}s: {switches} voluntary switches, {cpu_ns} ns CPU")
+        check(switches <= MAX_SWITCHES, f"{switches} voluntary context switches while idle")
+        check(cpu_ns <= MAX_CPU_NS, f"{cpu_ns} ns of CPU time while idle")
+
+        # A new AirPods reading gets through the filter and ends idle mode
+        since = time.monotonic()
+        payload = list(AIRPODS_PAYLOAD)
+        payload[6] = 0x88
+        check(h.mock.Advertise("hci0", ADDRESS, APPLE_CID, payload, -60), "advert dropped")
+        check(h.stdout.wait(lambda l: "L:80%" in l, 2.0, since), "widget not shown again")
+        check(h.stderr.wait(lambda l: "Leaving idle mode" in l, 2.0, since),
+              "still idle after an AirPods advert")
+        check(any(d == "DuplicateData=True" for _, _, _, d in
+                  h.calls("/org/bluez/hci0", "SetDiscoveryFilter", since)),
+              "duplicate reporting not turned back on")
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Two adapters hear the same AirPods: both scan, the advert is shown once."""
+
+import sys
+import time
+
+from harness import AIRPODS_PAYLOAD, APPLE_CID, Harness, check, run
+
+ADDRESS = "AA:BB:CC:DD:EE:FF"
+
+
+def test(binary):
+    with Harness(binary) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        h.mock.AddAdapter("hci1", "00:00:00:00:00:02", True)
+        h.mock.AddDevice("hci0", ADDRESS)
+        h.mock.AddDevice("hci1", ADDRESS)
+        h.start()
+
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+        h.wait_call("/org/bluez/hci1", "StartDiscovery")
+
+        # The same advert arrives through both adapters, hci1 hears it louder
+        since = time.monotonic()
+        check(h.mock.Advertise("hci0", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -70), "advert dropped")
+        check(h.mock.Advertise("hci1", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -50), "advert dropped")
+
+        shown = h.stdout.wait(lambda l: "L:90%" in l, 2.0, since)
+        check(shown, "battery levels were not shown")
+
+        stats = h.stats()
+        hci0 = stats["adapters"]["/org/bluez/hci0"]
+        hci1 = stats["adapters"]["/org/bluez/hci1"]
+        check(hci0["received"] == 1 and hci1["received"] == 1, f"received counts: {stats}")
+        check(hci0["forwarded"] == 1 and hci1["duplicates"] == 1, f"dedup counts: {stats}")
+        check(hci0["strongest_signal"] == 0 and hci1["strongest_signal"] == 1,
+              f"strongest signal counts: {stats}")
+        check(hci0["scanning"] and hci1["scanning"], f"scanning flags: {stats}")
+
+        lines = [l for t, l in h.stdout.snapshot() if t >= since and "L:90%" in l]
+        check(len(lines) == 1, f"expected one output line, got {lines}")
+
+        check(h.stop() == 0, "hyprpods did not exit cleanly on SIGTERM")
+        for adapter in ("hci0", "hci1"):
+            check(h.calls(f"/org/bluez/{adapter}", "StopDiscovery"),
+                  f"discovery left running on {adapter}")
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+"""When Waybar goes away, hyprpods notices without writing and exits cleanly."""
+
+import os
+import subprocess
+import sys
+import time
+
+from harness import Harness, check, run
+
+
+def test(binary):
+    with Harness(binary) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+
+        # Our end of hyprpods' stdout, standing in for Waybar
+        r, w = os.pipe()
+        h.start(stdout=w)
+        os.close(w)
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+
+        # Nothing new to show, so only the poll loop can tell
+        since = time.monotonic()
+        os.close(r)
+        try:
+            status = h.proc.wait(2.0)
+        except subprocess.TimeoutExpired:
+            status = None
+        check(status == 0, f"expected a clean exit, got {status}")
+        check(h.calls("/org/bluez/hci0", "StopDiscovery", since),
+              "discovery left running on the way out")
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""PrepareForSleep stops discovery and hides the widget; resume scans and shows it again."""
+
+import json
+import sys
+import time
+
+from harness import AIRPODS_PAYLOAD, APPLE_CID, Harness, check, run, wait_for
+
+ADDRESS = "AA:BB:CC:DD:EE:FF"
+
+
+def is_hidden(line):
+    try:
+        return json.loads(line).get("text") == ""
+    except ValueError:
+        return False
+
+
+def scan_cycle(binary):
+    with Harness(binary) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        h.mock.AddDevice("hci0", ADDRESS)
+        h.start()
+
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+        check(wait_for(lambda: h.mock.InhibitorsHeld() == 1, 2.0), "no delay inhibitor taken")
+
+        since = time.monotonic()
+        h.mock.Advertise("hci0", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -60)
+        check(h.stdout.wait(lambda l: "L:90%" in l, 2.0, since), "widget not shown")
+
+        # Suspend
+        since = time.monotonic()
+        h.mock.PrepareForSleep(True)
+        h.wait_call("/org/bluez/hci0", "StopDiscovery", since=since)
+        check(h.stdout.wait(is_hidden, 2.0, since), "widget not hidden for suspend")
+        check(wait_for(lambda: h.mock.InhibitorsHeld() == 0, 2.0),
+              "inhibitor still held, suspend would be delayed")
+
+        # Discovery really is off while asleep
+        check(not h.mock.Advertise("hci0", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -60),
+              "mock still discovering after StopDiscovery")
+
+        # Resume
+        since = time.monotonic()
+        h.mock.PrepareForSleep(False)
+        h.wait_call("/org/bluez/hci0", "StartDiscovery", since=since)
+        check(wait_for(lambda: h.mock.InhibitorsHeld() == 1, 2.0),
+              "inhibitor not taken again after resume")
+
+        # A new reading (L 80%), so the deduper can't mistake it for the pre-suspend advert
+        since = time.monotonic()
+        payload = list(AIRPODS_PAYLOAD)
+        payload[6] = 0x88
+        h.mock.Advertise("hci0", ADDRESS, APPLE_CID, payload, -60)
+        check(h.stdout.wait(lambda l: "L:80%" in l, 2.0, since), "widget not shown after resume")
+
+
+def connected_device(binary):
+    """A device connected across suspend: shown again at once, without stale levels."""
+    with Harness(binary) as h:
+        h.mock.AddAdapter("hci0", "00:00:00:00:00:01", True)
+        h.mock.AddDevice("hci0", ADDRESS)
+        h.start()
+        h.wait_call("/org/bluez/hci0", "StartDiscovery")
+
+        h.send({"cmd": "pair", "mac": ADDRESS})
+        h.wait_call("/org/bluez/hci0/dev_AA_BB_CC_DD_EE_FF", "Connect")
+        since = time.monotonic()
+        h.mock.Advertise("hci0", ADDRESS, APPLE_CID, AIRPODS_PAYLOAD, -60)
+        check(h.stdout.wait(lambda l: "L:90%" in l and '"connected"' in l, 2.0, since),
+              "connected device not shown")
+
+        since = time.monotonic()
+        h.mock.PrepareForSleep(True)
+        check(h.stdout.wait(is_hidden, 2.0, since), "widget not hidden for suspend")
+
+        # Nothing else happens after resume: the state must come out by itself
+        since = time.monotonic()
+        h.mock.PrepareForSleep(False)
+        shown = h.stdout.wait(lambda l: not is_hidden(l), 2.0, since)
+        check(shown, "still-connected device not shown after resume")
+        check('"connected"' in shown[1], f"not shown as connected: {shown[1]}")
+        check("L:--" in shown[1] and "R:--" in shown[1],
+              f"pre-suspend levels shown as current: {shown[1]}")
+
+
+def test(binary):
+    scan_cycle(binary)
+    connected_device(binary)
+
+
+if __name__ == "__main__":
+    sys.exit(run(test))
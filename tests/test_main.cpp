@@ -0,0 +1,21 @@
+#include "Test.h"
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+    // Usage: hyprpods_tests [filter]
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    int run = 0;
+    for (const auto &test : Test::cases()) {
+        if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos)
+            continue;
+        int before = Test::failures();
+        test.fn();
+        run++;
+        std::cout << (Test::failures() == before ? "ok     " : "FAILED ") << test.name << "\n";
+    }
+
+    std::cout << run << " tests, " << Test::failures() << " failed checks\n";
+    return Test::failures() == 0 ? 0 : 1;
+}